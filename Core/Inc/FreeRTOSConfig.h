@@ -45,29 +45,51 @@
 #if defined(__ICCARM__) || defined(__GNUC__) || defined(__CC_ARM) // IAR , GCC, ARM
 	#include <stdint.h>
 	extern uint32_t SystemCoreClock;
+	extern uint32_t cpu_stats_switches[];
+	extern uint32_t stack_mon_sizes[];
+	void cpu_stats_timer_init(void);
+	uint32_t cpu_stats_counter(void);
+	void lp_idle_sleep(uint32_t expected);
 #endif
 
 #define configUSE_PREEMPTION			1
 #define configUSE_TIME_SLICING 			1  // (default) this macro added by RV
-#define configUSE_IDLE_HOOK				0 //1
-#define configUSE_TICK_HOOK				0 //1
+#define configUSE_IDLE_HOOK				1 // drains the deferred log
+#define configUSE_TICK_HOOK				1 // extends the run time stats counter
+#define configUSE_TICKLESS_IDLE			1 // WFI or STOP mode (lp_idle.c)
 #define configCPU_CLOCK_HZ				( SystemCoreClock )
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES			( 5 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 130 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 100 * 1024 ) )
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 64 * 1024 ) ) // mem_heap.h regions (CCMRAM + SRAM)
 #define configMAX_TASK_NAME_LEN			( 10 )
 #define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
 #define configQUEUE_REGISTRY_SIZE		8
-#define configCHECK_FOR_STACK_OVERFLOW	0 //2
+#define configCHECK_FOR_STACK_OVERFLOW	2
+#define configRECORD_STACK_HIGH_ADDRESS	1 // stack size of the stack monitor
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configUSE_MALLOC_FAILED_HOOK	0 //1
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+#define configSUPPORT_STATIC_ALLOCATION	1 // tasks, queues and timers are created static
+#define configSUPPORT_DYNAMIC_ALLOCATION	1
+
+/* Run time statistics - DWT cycle counter (cpu_stats.c) */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	cpu_stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()			cpu_stats_counter()
+
+/* Tickless idle - WFI for short idle periods, STOP mode with the RTC wakeup timer for long ones (lp_idle.c) */
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime)	lp_idle_sleep(xExpectedIdleTime)
+
+/* Per task trace counters - indexed by the task number (TaskStatus_t xTaskNumber) */
+#define TRACE_TASKS_MAX					16 // power of 2, above the number of tasks
+#define traceTASK_SWITCHED_IN()			cpu_stats_switches[pxCurrentTCB->uxTCBNumber & (TRACE_TASKS_MAX - 1)]++
+#define traceTASK_CREATE(pxNewTCB)		stack_mon_sizes[(pxNewTCB)->uxTCBNumber & (TRACE_TASKS_MAX - 1)] = \
+											(pxNewTCB)->pxEndOfStack - (pxNewTCB)->pxStack + 1
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
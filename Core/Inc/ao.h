@@ -0,0 +1,73 @@
+/*
+ * ao.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_AO_H_
+#define INC_AO_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+
+/*
+ * Active objects.
+ * An active object is an event handler with its own static event queue. One dispatcher task (ao_run())
+ * runs all the active objects: it takes one event at a time from the highest priority non empty queue
+ * and runs the handler to completion - the handlers never wait for input, they keep their state between
+ * events. The priority is the ao_start() order (the first object is the highest).
+ * Every event is stamped with the DWT cycle counter when posted - the statistics hold the queueing
+ * latency and the handler run time.
+ */
+
+#define AO_MAX				8		/* registered active objects */
+
+/* Event signals - the application signals start at AO_SIG_USER */
+enum{
+	AO_SIG_ENTRY = 0,		/* the object takes over (e.g. shows its prompt) */
+	AO_SIG_USER
+};
+
+/* Event - copied into the queue */
+typedef struct{
+	uint16_t sig;
+	uint16_t param;
+	void* data;
+	uint32_t stamp;			/* cycle counter at the post - set by ao_post() */
+}ao_event_t;
+
+typedef struct ao ao_t;
+
+/* Event handler - runs to completion in the dispatcher task */
+typedef void (*ao_handler_t)(ao_t* me, const ao_event_t* e);
+
+/* Active object statistics (cycles) */
+typedef struct{
+	uint32_t events;		/* handled events */
+	uint32_t dropped;		/* posts that found the queue full */
+	uint32_t depth_max;		/* queue high-water mark */
+	uint32_t lat_max;		/* max post to dispatch latency */
+	uint32_t run_max;		/* max handler run time */
+	uint64_t lat_sum;
+}ao_stats_t;
+
+struct ao{
+	const char* name;
+	ao_handler_t handler;
+	QueueHandle_t queue;
+	StaticQueue_t queue_struct;
+	ao_stats_t stats;
+};
+
+/* Queue storage of an active object (len events) */
+#define AO_QUEUE_STORAGE(len)	((len) * sizeof(ao_event_t))
+
+void ao_start(ao_t* me, const char* name, ao_handler_t handler, uint8_t* storage, uint32_t len);
+BaseType_t ao_post(ao_t* me, const ao_event_t* e);
+BaseType_t ao_post_from_isr(ao_t* me, const ao_event_t* e, BaseType_t* woken);
+void ao_run(void);
+void ao_report(TickType_t timeout);
+
+#endif /* INC_AO_H_ */
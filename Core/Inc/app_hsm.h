@@ -0,0 +1,26 @@
+/*
+ * app_hsm.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_APP_HSM_H_
+#define INC_APP_HSM_H_
+
+#include "hsm.h"
+
+/*
+ * Console state machine definition.
+ * The states (state_t) with their entry and exit actions and the transitions (app_event_t) of the
+ * console menus. Run by the dispatcher task (tasks_handler.c), verified on the host by tests/test_hsm.c.
+ */
+
+extern const hsm_def_t app_hsm_def;
+
+/* Entry actions - show the menu of the state */
+void menu_entry(void);
+void leds_entry(void);
+void rtc_entry(void);
+
+#endif /* INC_APP_HSM_H_ */
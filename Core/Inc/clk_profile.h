@@ -0,0 +1,41 @@
+/*
+ * clk_profile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_CLK_PROFILE_H_
+#define INC_CLK_PROFILE_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "FreeRTOS.h"
+
+/*
+ * System clock profiles.
+ * Each profile sets the oscillators, the PLL, the bus prescalers and the flash wait states (RM0090
+ * table 10, 2.7 - 3.6 V). A switch keeps the peripherals that depend on the bus clocks running at the
+ * same rate: the USART2 baud rate register, the TIM7 prescaler (the LED effects period), the SysTick
+ * (the kernel tick) and the SWO prescaler when a debugger is attached.
+ * The boot clock (SystemClock_Config(), CubeMX) is replaced by CLK_PROFILE_BOOT after the peripherals
+ * are initialized.
+ */
+
+typedef enum{
+	CLK_PROFILE_PERF = 0,		/* 168 MHz - HSE / PLL, 5 wait states */
+	CLK_PROFILE_BALANCED,		/* 100 MHz - HSE / PLL, 3 wait states */
+	CLK_PROFILE_LOW,			/* 16 MHz - HSI, no PLL, 0 wait states */
+	CLK_PROFILE_NUM
+}clk_profile_t;
+
+#define CLK_PROFILE_BOOT		CLK_PROFILE_PERF
+#define CLK_PROFILE_DRAIN_MS	100		/* console output drain before a switch */
+
+void clk_profile_init(void);
+HAL_StatusTypeDef clk_profile_set(clk_profile_t profile);
+void clk_profile_restore(void);
+clk_profile_t clk_profile_get(void);
+void clk_profile_report(TickType_t timeout);
+
+#endif /* INC_CLK_PROFILE_H_ */
@@ -0,0 +1,58 @@
+/*
+ * cmd_args.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_CMD_ARGS_H_
+#define INC_CMD_ARGS_H_
+
+#include <stdint.h>
+
+#define CMD_MAX_ARGS		4
+
+/* Argument types */
+typedef enum{
+	ARG_INT,		/* decimal integer within [min, max] */
+	ARG_ENUM,		/* one of the keywords (case insensitive) */
+	ARG_STR			/* any token - a slice of the input line */
+}arg_type_t;
+
+/* Argument schema */
+typedef struct{
+	arg_type_t type;
+	int32_t min;					/* ARG_INT range */
+	int32_t max;
+	const char* const* keywords;	/* ARG_ENUM - NULL terminated list */
+}arg_spec_t;
+
+/* Parsed argument */
+typedef struct{
+	arg_type_t type;
+	union{
+		int32_t num;				/* ARG_INT value */
+		uint32_t idx;				/* ARG_ENUM keyword index */
+		struct{
+			const char* ptr;		/* ARG_STR slice - not null terminated */
+			uint32_t len;
+		}str;
+	};
+}arg_val_t;
+
+/* Parse errors */
+typedef enum{
+	ARGS_OK = 0,
+	ARGS_ERR_MISSING,		/* less arguments than the schema */
+	ARGS_ERR_EXTRA,			/* more arguments than the schema */
+	ARGS_ERR_NOT_NUMBER,	/* not a decimal number or trailing garbage */
+	ARGS_ERR_OVERFLOW,		/* number does not fit 32 bits */
+	ARGS_ERR_RANGE,			/* number out of the schema range */
+	ARGS_ERR_KEYWORD		/* not one of the schema keywords */
+}args_err_t;
+
+args_err_t args_parse(const char* line, uint32_t len, const arg_spec_t* spec, uint32_t nspec,
+					  arg_val_t* out, uint32_t* err_pos);
+const char* args_err_msg(args_err_t err);
+
+#endif /* INC_CMD_ARGS_H_ */
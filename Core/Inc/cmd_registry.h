@@ -0,0 +1,61 @@
+/*
+ * cmd_registry.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_CMD_REGISTRY_H_
+#define INC_CMD_REGISTRY_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "cmd_args.h"
+
+/* Command groups - the same name may be used by different groups (menus) */
+typedef enum{
+	CMD_GROUP_MENU,
+	CMD_GROUP_LEDS,
+	CMD_GROUP_RTC,
+	CMD_GROUP_NUM
+}cmd_group_t;
+
+/* Command handler - returns the handler specific result (e.g. non zero to exit the menu).
+ * args holds the arguments parsed by the entry schema (nargs entries). */
+typedef uint32_t (*cmd_handler_t)(uint32_t param, const arg_val_t* args);
+
+/* Command table entry */
+typedef struct{
+	cmd_group_t group;
+	const char* name;
+	uint8_t nargs;			/* number of space separated arguments after the name */
+	const arg_spec_t* args;	/* arguments schema (nargs entries), NULL if nargs is 0 */
+	cmd_handler_t handler;
+	uint32_t param;			/* passed to the handler */
+}cmd_entry_t;
+
+/* Dispatch errors */
+#define CMD_ERR_NOT_FOUND	(-1)
+#define CMD_ERR_ARGS_BASE	(-16)	/* CMD_ERR_ARGS_BASE - args_err_t */
+#define CMD_ERR_ARGS(err)	(CMD_ERR_ARGS_BASE - (int32_t)(err))
+#define CMD_IS_ERR_ARGS(r)	((r) <= CMD_ERR_ARGS_BASE)
+#define CMD_ARGS_ERR(r)		((args_err_t)(CMD_ERR_ARGS_BASE - (r)))
+
+/* Hash table size (power of 2) - must be larger than the number of registered commands */
+#define CMD_HASH_SIZE		64
+
+/* Collision free hash seed of the registered commands - checked by tests/test_cmd_registry.c, which
+ * prints a new one when the commands change */
+#define CMD_HASH_SEED		95
+
+/* Subsystem tables, terminated by an entry with a NULL name */
+extern const cmd_entry_t menu_cmds[];
+extern const cmd_entry_t leds_cmds[];
+extern const cmd_entry_t rtc_cmds[];
+
+void cmd_registry_init(void);
+BaseType_t cmd_registry_build(uint32_t seed);
+const cmd_entry_t* cmd_lookup(cmd_group_t group, const char* name, uint32_t len);
+int32_t cmd_dispatch(cmd_group_t group, const char* line, uint32_t len);
+
+#endif /* INC_CMD_REGISTRY_H_ */
@@ -0,0 +1,25 @@
+/*
+ * cobs.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_COBS_H_
+#define INC_COBS_H_
+
+#include <stdint.h>
+
+/*
+ * Consistent Overhead Byte Stuffing.
+ * The encoded data holds no zero byte, so a zero delimits the frames on the byte stream.
+ * The overhead is one byte per 254 bytes (at least one byte).
+ */
+
+/* Encoded size of len bytes (worst case) */
+#define COBS_ENC_MAX(len)	((len) + (len) / 254 + 1)
+
+uint32_t cobs_encode(const uint8_t* in, uint32_t len, uint8_t* out);
+int32_t cobs_decode(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t size);
+
+#endif /* INC_COBS_H_ */
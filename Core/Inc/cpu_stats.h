@@ -0,0 +1,32 @@
+/*
+ * cpu_stats.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_CPU_STATS_H_
+#define INC_CPU_STATS_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/*
+ * Run time statistics.
+ * The kernel run time counter is the DWT cycle counter, extended to 64 bits (the 32 bits counter wraps
+ * every 2^32 / SystemCoreClock seconds) and scaled down by CPU_STATS_SHIFT. The context switches are
+ * counted per task by traceTASK_SWITCHED_IN(). Nothing runs while the stats are not read: every
+ * cpu_stats_report() samples the tasks and prints the delta against the previous report. The time in
+ * STOP (lp_idle.h, the DWT is stopped) is counted as idle time, and each sample records the core clock -
+ * a window across a clock profile switch restarts.
+ */
+
+#define CPU_STATS_SHIFT			4		/* run time counter = cycles >> CPU_STATS_SHIFT */
+
+void cpu_stats_init(void);
+void cpu_stats_timer_init(void);
+uint32_t cpu_stats_counter(void);
+uint64_t cpu_stats_cycles(void);
+void cpu_stats_report(TickType_t timeout);
+
+#endif /* INC_CPU_STATS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * dlog.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_DLOG_H_
+#define INC_DLOG_H_
+
+#include <stdint.h>
+
+/*
+ * Deferred binary log.
+ * DLOG() stores only the format string ID, a timestamp and the raw 32 bits arguments in a RAM ring.
+ * The format strings are placed in the .log_fmt section that is not loaded to the target (INFO),
+ * the ID is the string offset in the section. The ring is drained to ITM stimulus port DLOG_ITM_PORT
+ * from the idle task and tools/log_decode.py rebuilds the text from the ELF.
+ *
+ * Record (32 bits words): DLOG_SYNC | nargs << 20 | ID, tick count (0 before the scheduler starts), args...
+ * 						   DLOG_SYNC | DLOG_NARGS_BUF << 20 | ID, tick count, length, data (padded to words)
+ */
+
+#define DLOG_RING_WORDS		512			/* power of 2 */
+#define DLOG_ITM_PORT		1
+#define DLOG_MAX_ARGS		8
+#define DLOG_MAX_BUF		64			/* DLOG_BUF() max data length */
+
+#define DLOG_SYNC			0xA5000000U
+#define DLOG_NARGS_BUF		0xF			/* the record holds a data buffer */
+#define DLOG_ID_MASK		0x000FFFFFU
+
+/* Log statistics */
+typedef struct{
+	uint32_t records;	/* records written */
+	uint32_t dropped;	/* records dropped - the ring was full */
+	uint32_t words;		/* words drained to the ITM */
+}dlog_stats_t;
+
+extern dlog_stats_t dlog_stats;
+
+/* Format string ID - the string is kept out of the image */
+#define DLOG_FMT_ID(fmt)	({ static const char dlog_fmt[] __attribute__((section(".log_fmt"), used)) = fmt;	\
+							   (uint32_t)dlog_fmt; })
+
+#define DLOG_NARGS(...)		DLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)	n
+
+/**
+ * @brief Log a message - the arguments are 32 bits values (integers, chars or pointers to const strings in flash)
+ *
+ * @note Can be called from a task, an ISR or before the scheduler starts
+ * */
+#define DLOG(fmt, ...)		dlog_write(DLOG_FMT_ID(fmt), DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+/**
+ * @brief Log a data buffer (e.g. formatted text) - the format string gets the data as %s
+ * */
+#define DLOG_BUF(fmt, data, len)	dlog_write_buf(DLOG_FMT_ID(fmt), data, len)
+
+void dlog_write(uint32_t id, uint32_t nargs, ...);
+void dlog_write_buf(uint32_t id, const void* data, uint32_t len);
+void dlog_drain(void);
+
+#endif /* INC_DLOG_H_ */
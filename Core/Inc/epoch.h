@@ -0,0 +1,49 @@
+/*
+ * epoch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_EPOCH_H_
+#define INC_EPOCH_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/* Supported calendar range - the RTC holds years 00-99 */
+#define EPOCH_YEAR_MIN		2000
+#define EPOCH_YEAR_MAX		2099
+#define EPOCH_RTC_YEAR_BASE	EPOCH_YEAR_MIN		/* RTC year 0 */
+
+/* Calendar date and time (24 hours) */
+typedef struct{
+	uint16_t year;		/* 2000 - 2099 */
+	uint8_t month;		/* 1 - 12 */
+	uint8_t day;		/* 1 - 31 */
+	uint8_t hours;		/* 0 - 23 */
+	uint8_t minutes;	/* 0 - 59 */
+	uint8_t seconds;	/* 0 - 59 */
+	uint8_t weekday;	/* RTC_WEEKDAY_MONDAY (1) - RTC_WEEKDAY_SUNDAY (7) */
+}civil_time_t;
+
+uint32_t epoch_month_days(uint32_t year, uint32_t month);
+uint32_t epoch_weekday(uint32_t days);
+
+uint32_t epoch_days_from_civil(uint32_t year, uint32_t month, uint32_t day);
+void epoch_civil_from_days(uint32_t days, civil_time_t* ct);
+
+uint32_t epoch_from_civil(const civil_time_t* ct);
+void epoch_to_civil(uint32_t secs, civil_time_t* ct);
+
+uint64_t epoch_ms_from_civil(const civil_time_t* ct, uint32_t ms);
+uint32_t epoch_ms_to_civil(uint64_t ms, civil_time_t* ct);
+
+void epoch_civil_from_rtc(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format,
+						  civil_time_t* ct);
+void epoch_civil_to_rtc(const civil_time_t* ct, uint32_t hour_format, RTC_TimeTypeDef* sTime,
+						RTC_DateTypeDef* sDate);
+uint32_t epoch_from_rtc(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format);
+void epoch_to_rtc(uint32_t secs, uint32_t hour_format, RTC_TimeTypeDef* sTime, RTC_DateTypeDef* sDate);
+
+#endif /* INC_EPOCH_H_ */
@@ -0,0 +1,78 @@
+/*
+ * hsm.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_HSM_H_
+#define INC_HSM_H_
+
+#include <stdint.h>
+
+/*
+ * Hierarchical state machine.
+ * The states (parent, entry and exit actions) and the transitions are constant tables. A state
+ * inherits the transitions of its parents: hsm_init() resolves the inheritance once into a flat
+ * [state][event] table, so an event lookup is a single index whatever the depth of the tree.
+ * The transitions are external: the states are exited up to the common ancestor of the source and
+ * the target (the target itself when it is an ancestor of the source) and entered down to the target.
+ * The target becomes the current state - there are no initial transitions into a child state.
+ * No kernel or HAL dependency - the tables can be verified on the host with hsm_init().
+ */
+
+#define HSM_NONE			0xFF	/* no parent, unhandled event */
+#define HSM_DEPTH_MAX		4		/* nesting levels */
+
+/* Flat transitions table of hsm_init() */
+#define HSM_TABLE_SIZE(nstates, nevents)	((nstates) * (nevents))
+
+typedef void (*hsm_action_t)(void);
+
+/* State - indexed by the state id */
+typedef struct{
+	uint8_t parent;			/* HSM_NONE for a top state */
+	hsm_action_t entry;		/* NULL if none */
+	hsm_action_t exit;		/* NULL if none */
+}hsm_state_t;
+
+/* Transition - the event is handled by the source and its children */
+typedef struct{
+	uint8_t source;
+	uint8_t event;
+	uint8_t target;
+}hsm_transition_t;
+
+/* State machine definition */
+typedef struct{
+	const hsm_state_t* states;
+	const hsm_transition_t* transitions;
+	uint8_t nstates;
+	uint8_t nevents;
+	uint8_t ntransitions;
+	uint8_t initial;
+}hsm_def_t;
+
+typedef struct{
+	const hsm_def_t* def;
+	uint8_t* table;			/* HSM_TABLE_SIZE() targets - built by hsm_init() */
+	uint8_t current;
+}hsm_t;
+
+/* hsm_init() result */
+typedef enum{
+	HSM_OK = 0,
+	HSM_ERR_SIZE,			/* no states or events, or an id collides with HSM_NONE */
+	HSM_ERR_PARENT,			/* invalid parent, loop or too deep nesting */
+	HSM_ERR_TRANSITION,		/* source, event or target out of range */
+	HSM_ERR_DUPLICATE,		/* the same source and event declared twice */
+	HSM_ERR_UNREACHABLE		/* a state that no event path from the initial state reaches */
+}hsm_err_t;
+
+hsm_err_t hsm_init(hsm_t* me, const hsm_def_t* def, uint8_t* table);
+void hsm_start(hsm_t* me);
+uint32_t hsm_dispatch(hsm_t* me, uint8_t event);
+uint8_t hsm_state(const hsm_t* me);
+uint32_t hsm_in(const hsm_t* me, uint8_t state);
+
+#endif /* INC_HSM_H_ */
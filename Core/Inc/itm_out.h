@@ -0,0 +1,46 @@
+/*
+ * itm_out.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_ITM_OUT_H_
+#define INC_ITM_OUT_H_
+
+#include <stdint.h>
+
+/*
+ * Buffered ITM (SWO) output.
+ * Each channel is a byte ring drained to its own ITM stimulus port. The writers never wait:
+ * the space is reserved lock-free (LDREX/STREX) so any task or ISR - of any priority - can write,
+ * the data that does not fit is dropped and counted. The idle task drains the rings with 32 bits
+ * stimulus writes while the ITM FIFO has room.
+ */
+
+/* Output channels - ITM stimulus port 1 is used by the deferred log (dlog.h). A new channel needs a
+ * producer: a ring and a port in itm_out.c. */
+typedef enum{
+	ITM_CH_LOG = 0,		/* printf text, port 0 */
+	ITM_CH_NUM
+}itm_ch_t;
+
+#define ITM_OUT_LOG_PORT		0
+
+/* Ring size - power of 2, up to 32 KB */
+#define ITM_OUT_LOG_SIZE		1024
+
+/* Channel statistics */
+typedef struct{
+	uint32_t written;	/* bytes written to the ring */
+	uint32_t dropped;	/* bytes dropped - the ring was full or the port is disabled */
+	uint32_t drained;	/* bytes sent to the ITM */
+}itm_out_stats_t;
+
+extern itm_out_stats_t itm_out_stats[ITM_CH_NUM];
+
+void itm_out_init(void);
+uint32_t itm_out_write(itm_ch_t ch, const void* data, uint32_t len);
+void itm_out_drain(void);
+
+#endif /* INC_ITM_OUT_H_ */
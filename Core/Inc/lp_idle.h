@@ -0,0 +1,47 @@
+/*
+ * lp_idle.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_LP_IDLE_H_
+#define INC_LP_IDLE_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/*
+ * Tickless idle (portSUPPRESS_TICKS_AND_SLEEP).
+ * Short idle periods sleep with WFI and the SysTick reprogrammed by the port (vPortSuppressTicksAndSleep).
+ * Long idle periods enter STOP mode: the RTC wakeup timer (RTCCLK / 16, the LSI) ends the sleep, a falling
+ * edge on the USART2 RX pin (EXTI3) wakes on console input - the first character is lost. The clock tree
+ * is restored by clk_profile_restore() and the kernel tick is stepped by the time measured on the RTC.
+ * STOP is held off while it would break a running activity: RTC report subscriptions (the wakeup timer),
+ * a LED effect (TIM7), a UART transmission, or a recent console input.
+ */
+
+#define LP_IDLE_STOP_MIN_MS		50		/* shorter idle periods sleep with WFI */
+#define LP_IDLE_STOP_MAX_MS		30000	/* the wakeup timer range is 32 s with RTCCLK / 16 */
+#define LP_IDLE_CONSOLE_MS		10000	/* console inactivity before STOP is allowed */
+
+/* Idle statistics */
+typedef struct{
+	uint32_t wfi_sleeps;		/* WFI sleeps */
+	uint32_t wfi_ms;			/* time in WFI (ms) */
+	uint32_t stop_entries;		/* STOP entries */
+	uint32_t stop_ms;			/* time in STOP (ms) */
+	uint32_t uart_wakes;		/* STOP ended by console input */
+	uint32_t lat_last_us;		/* clock restore latency of the last STOP exit */
+	uint32_t lat_max_us;
+	uint64_t lat_sum_us;
+	const char* hold;			/* the last reason STOP was held off, NULL if none */
+}lp_idle_stats_t;
+
+extern lp_idle_stats_t lp_idle_stats;
+
+void lp_idle_init(void);
+void lp_idle_sleep(TickType_t expected);
+void lp_idle_report(TickType_t timeout);
+
+#endif /* INC_LP_IDLE_H_ */
@@ -39,6 +39,7 @@ extern "C" {
 #include "timers.h"
 
 #include "stm32f407x_disc_board.h"
+#include "cmd_args.h"
 
 /* USER CODE END Includes */
 
@@ -46,24 +47,47 @@ extern "C" {
 /* USER CODE BEGIN ET */
 typedef struct
 {
-	char payload[10];
+	char payload[32];	/* longest command: "set YYYY-MM-DDTHH:MM:SS" */
 	uint32_t len;
 }command_t;
 
+#define CMD_POOL_SIZE		32	/* Max number of commands waiting to be consumed - pipelined requests */
+
+/* Releases a transmitted message buffer - NULL for messages that are never released (constant strings) */
+typedef void (*tx_release_t)(void* msg);
+
+/* Print queue item */
 typedef struct{
-	uint8_t* msg;
+	const uint8_t* msg;
 	uint32_t len;
+	tx_release_t release;	/* called by the print task once the message is no longer used */
 }tx_command_t;
 
+/* Console states (app_states[]) */
 typedef enum {
 	sMainMenu,
+	sMainIdle,			/* the menu waits for any input to show again */
 	sLedEffect,
 	sRtcMenu,
 	sRtcTimeConfig,
 	sRtcDateConfig,
-	sRtcReport
+	sRtcReport,
+	sNum
 }state_t;
 
+/* Console events (app_transitions[]) */
+typedef enum {
+	evLeds,				/* open the LEDs menu */
+	evRtc,				/* open the RTC menu */
+	evBack,				/* back to Main Menu */
+	evIdle,				/* hide the menu until the next input */
+	evDone,				/* the menu of the state again - ends a value prompt */
+	evTime,				/* time configuration prompt */
+	evDate,				/* date configuration prompt */
+	evReport,			/* report enable prompt */
+	evNum
+}app_event_t;
+
 typedef enum{
 	exec_none,
 	exec_e1,
@@ -73,49 +97,52 @@ typedef enum{
 }eLeds_exec_t;
 
 /* Queues */
-extern QueueHandle_t q_data;		/* Queue of input data  */
 extern QueueHandle_t q_print;		/* Queue of output data  */
 
 /* Tasks Handles */
-extern TaskHandle_t menu_task_handle;
-extern TaskHandle_t leds_task_handle;
-extern TaskHandle_t rtc_task_handle;
+extern TaskHandle_t ao_task_handle;
 extern TaskHandle_t print_task_handle;
 extern TaskHandle_t cmd_handler_task_handle;
+extern TaskHandle_t rtc_report_task_handle;
 extern TaskHandle_t taskToNotify;
 
 /* Peripherals instances */
 extern UART_HandleTypeDef huart2;	/* USART handle */
 extern RTC_HandleTypeDef hrtc;		/* RTC handle */
 extern TIM_HandleTypeDef htim7;		/* TIM handle */
-extern TimerHandle_t rtc_timer;		/* SW timer handle to handle rtc time and date report */
 
 
 /* Application flags */
-extern state_t app_curr_state;
+extern uint32_t cmd_dropped;
+extern uint32_t cmd_overlong;
 extern volatile eLeds_exec_t exec_flag;
 
-/* User data */
-extern uint8_t user_data;
-extern uint8_t uart_tx_buff[512];
-
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
 
+/* CCMRAM data that is not initialized by the startup code - CPU only, the DMA can't access CCMRAM */
+#define CCMRAM_NOINIT		__attribute__((section(".ccm_noinit")))
+
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
-void menu_task_handler(void* params);
-void leds_task_handler(void* params);
-void rtc_task_handler(void* params);
-void rtc_task_handler(void* params);
+void ao_task_handler(void* params);
 void print_task_handler(void* params);
 void command_handle_task_handler(void* params);
 
-void queue_send_msg(char* message, TickType_t timeout);
+void cmd_pool_init(void);
+command_t* cmd_alloc(void);
+void cmd_release(command_t* cmd);
+
+void app_ao_init(void);
+state_t app_state(void);
+void app_event(app_event_t event);
+
+BaseType_t queue_send_msg(const char* message, TickType_t timeout);
+BaseType_t queue_send_buff(const uint8_t* msg, uint32_t len, tx_release_t release, TickType_t timeout);
 
 
 /* LEDs functions prototypes*/
@@ -124,13 +151,24 @@ void exec_leds_e2(void);
 void exec_leds_e3(void);
 void exec_leds_e4(void);
 void leds_execute_handler();
+uint32_t leds_execute(uint32_t effect, const arg_val_t* args);
+uint32_t leds_exit(uint32_t param, const arg_val_t* args);
+void leds_stop(void);
+
+/* RTC menu handlers result */
+#define RTC_RET_MENU		0	/* show the RTC menu again */
+#define RTC_RET_EXIT		1	/* back to Main Menu */
+#define RTC_RET_PROMPT		2	/* a value prompt is shown - the next input goes to rtc_input() */
+
+uint32_t rtc_execute(uint32_t option, const arg_val_t* args);
+uint32_t rtc_input(const char* payload, uint32_t len);
+uint32_t rtc_set_datetime(uint32_t param, const arg_val_t* args);
+uint32_t rtc_report_sub_cmd(uint32_t param, const arg_val_t* args);
+uint32_t rtc_report_unsub_cmd(uint32_t param, const arg_val_t* args);
 
 void rtc_q_print_time_n_date(void);
 void rtc_q_print_time(void);
 
-/* Callback */
-void rtc_timer_callback(TimerHandle_t xTimer); /* SW timer */
-
 /* USER CODE END EM */
 
 /* Exported functions prototypes ---------------------------------------------*/
@@ -0,0 +1,50 @@
+/*
+ * mem_heap.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_MEM_HEAP_H_
+#define INC_MEM_HEAP_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+/*
+ * Multi region heap - replaces heap_4.
+ * Each region is a first fit, address ordered free list with coalescing (the heap_4/heap_5 scheme).
+ * mem_alloc() allocates from a given region, pvPortMalloc() (kernel objects) prefers CCMRAM and falls
+ * back to SRAM. mem_free()/vPortFree() find the region by the block address.
+ */
+
+typedef enum{
+	MEM_REGION_CCM = 0,		/* CCMRAM - CPU only, not reachable by the DMA */
+	MEM_REGION_SRAM,		/* SRAM - DMA capable */
+	MEM_REGION_NUM
+}mem_region_t;
+
+/* Region sizes (bytes) */
+#define MEM_HEAP_CCM_SIZE		(32 * 1024)
+#define MEM_HEAP_SRAM_SIZE		(32 * 1024)
+
+/* Region statistics */
+typedef struct{
+	size_t size;			/* usable bytes */
+	size_t free;			/* free bytes */
+	size_t min_free;		/* minimum ever free bytes */
+	size_t largest;			/* largest free block */
+	size_t blocks;			/* free blocks - fragmentation */
+	uint32_t allocs;		/* successful allocations */
+	uint32_t frees;			/* successful frees */
+	uint32_t fails;			/* failed allocations */
+}mem_heap_stats_t;
+
+void mem_heap_init(void);
+void* mem_alloc(mem_region_t region, size_t size);
+void mem_free(void* ptr);
+void mem_heap_get_stats(mem_region_t region, mem_heap_stats_t* stats);
+void mem_heap_report(TickType_t timeout);
+
+#endif /* INC_MEM_HEAP_H_ */
@@ -0,0 +1,34 @@
+/*
+ * msg_pool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_MSG_POOL_H_
+#define INC_MSG_POOL_H_
+
+#include <stdint.h>
+
+/* Pool configuration - sized for the worst case report burst */
+#define MSG_POOL_BLOCK_SIZE		64		/* bytes, multiple of 4 */
+#define MSG_POOL_BLOCKS			16
+
+/* Place the pool in CCMRAM (CPU only - the TX path copies the blocks to the DMA buffers) */
+#define MSG_POOL_IN_CCMRAM		1
+
+/* Pool statistics */
+typedef struct{
+	uint32_t used;			/* blocks in use */
+	uint32_t used_max;		/* high-water mark of blocks in use */
+	uint32_t allocs;		/* successful allocations */
+	uint32_t alloc_fail;	/* allocations failed - pool exhausted */
+}msg_pool_stats_t;
+
+extern msg_pool_stats_t msg_pool_stats;
+
+void msg_pool_init(void);
+void* msg_pool_alloc(void);
+void msg_pool_free(void* block);
+
+#endif /* INC_MSG_POOL_H_ */
@@ -0,0 +1,77 @@
+/*
+ * proto.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_PROTO_H_
+#define INC_PROTO_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "ring_buff.h"
+
+/*
+ * Binary request / response protocol for machine clients, on the console UART next to the text menu.
+ * Frame on the line: 0x00 <COBS data> 0x00. A text line never starts with a zero byte, so every frame
+ * is detected by its leading delimiter - the text menu is not affected and keeps its state.
+ * Request:  version, sequence, command, data..., CRC
+ * Response: version, sequence, command | PROTO_RSP, status, data..., CRC
+ * The CRC is the CRC peripheral CRC-32 (poly 0x04C11DB7, init 0xFFFFFFFF, no reflection) over the frame
+ * bytes read as little endian 32 bits words, the last word zero padded. It is sent little endian.
+ * The requests are handled in order with no prompt, a client may send several requests before the
+ * responses arrive: up to CMD_POOL_SIZE requests wait in the board and UART_RX_RING_SIZE bytes in the
+ * input ring, the others are dropped (no response) - a pipelining client keeps at most CMD_POOL_SIZE
+ * requests without a response.
+ * A frame with a bad CRC gets no response. The multi byte fields are little endian.
+ */
+
+#define PROTO_VERSION		1
+#define PROTO_DELIM			0x00
+
+#define PROTO_HDR_SIZE		3		/* version, sequence, command */
+#define PROTO_CRC_SIZE		4
+#define PROTO_FRAME_MAX		32		/* decoded frame - the command_t payload */
+#define PROTO_RX_TIMEOUT_MS	100		/* a partial frame older than this is taken as text */
+#define PROTO_TX_TIMEOUT_MS	50		/* max wait for a print queue slot - the response is dropped after it */
+
+#define PROTO_RSP			0x80	/* response flag of the command byte */
+
+/* Requests */
+typedef enum{
+	PROTO_CMD_PING = 0x01,			/* data echoed back */
+	PROTO_CMD_INFO = 0x02,			/* u32 tick count, u32 HCLK, u8 clock profile, u8 max frame */
+	PROTO_CMD_TIME_GET = 0x10,		/* u64 Unix time (ms) */
+	PROTO_CMD_TIME_SET = 0x11,		/* u32 Unix time (s) - 2000 to 2099 */
+	PROTO_CMD_LED = 0x20,			/* u8 effect - 0 off, 1 - 4 */
+	PROTO_CMD_STATS = 0x30			/* proto_stats_t */
+}proto_cmd_t;
+
+/* Response status */
+typedef enum{
+	PROTO_OK = 0,
+	PROTO_ERR_VERSION,				/* the response holds the board version */
+	PROTO_ERR_CMD,					/* unknown command */
+	PROTO_ERR_LEN,					/* wrong data length */
+	PROTO_ERR_ARG					/* argument out of range */
+}proto_status_t;
+
+/* Protocol statistics */
+typedef struct{
+	uint32_t frames;		/* handled requests */
+	uint32_t crc_errors;	/* CRC mismatch - no response */
+	uint32_t bad_frames;	/* COBS error, too short or too long frame */
+	uint32_t dropped;		/* no free command slot - no response */
+	uint32_t timeouts;		/* partial frames taken as text */
+	uint32_t tx_dropped;	/* responses lost - message pool exhausted or print queue full */
+}proto_stats_t;
+
+extern proto_stats_t proto_stats;
+
+void proto_init(void);
+uint32_t proto_frame_start(const ring_buff_t* rb);
+int proto_receive(ring_buff_t* rb);
+TickType_t proto_rx_wait(void);
+
+#endif /* INC_PROTO_H_ */
@@ -0,0 +1,44 @@
+/*
+ * ring_buff.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_RING_BUFF_H_
+#define INC_RING_BUFF_H_
+
+#include <stdint.h>
+
+/*
+ * Single producer / single consumer lock-free byte ring.
+ * The producer (ISR) only writes head, the consumer (task) only writes tail.
+ * The indices run freely and are masked on access, so the size must be a power of 2.
+ */
+typedef struct{
+	uint8_t* buff;
+	uint32_t mask;				/* size - 1 */
+	volatile uint32_t head;		/* producer index */
+	volatile uint32_t tail;		/* consumer index */
+}ring_buff_t;
+
+/* A contiguous part of the ring data */
+typedef struct{
+	const uint8_t* data;
+	uint32_t len;
+}ring_span_t;
+
+void ring_buff_init(ring_buff_t* rb, uint8_t* buff, uint32_t size);
+
+/* Producer API */
+uint32_t ring_buff_write(ring_buff_t* rb, const uint8_t* data, uint32_t len);
+uint32_t ring_buff_free(const ring_buff_t* rb);
+
+/* Consumer API */
+uint32_t ring_buff_count(const ring_buff_t* rb);
+int32_t ring_buff_find(const ring_buff_t* rb, uint8_t ch);
+uint32_t ring_buff_peek(const ring_buff_t* rb, uint32_t len, ring_span_t spans[2]);
+uint32_t ring_buff_read(ring_buff_t* rb, uint8_t* data, uint32_t len);
+void ring_buff_consume(ring_buff_t* rb, uint32_t len);
+
+#endif /* INC_RING_BUFF_H_ */
@@ -0,0 +1,34 @@
+/*
+ * rtc_cache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_RTC_CACHE_H_
+#define INC_RTC_CACHE_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/* Coherent RTC snapshot - time and date read together */
+typedef struct{
+	RTC_TimeTypeDef time;		/* SubSeconds - raw SSR, SecondFraction - PREDIV_S */
+	RTC_DateTypeDef date;
+	uint32_t subsec_us;			/* microseconds within the current second */
+}rtc_snapshot_t;
+
+/* Cache statistics */
+typedef struct{
+	uint32_t hits;			/* reads served from the cache */
+	uint32_t reads;			/* RTC peripheral reads */
+}rtc_cache_stats_t;
+
+extern rtc_cache_stats_t rtc_cache_stats;
+
+void rtc_cache_get(rtc_snapshot_t* snap);
+uint64_t rtc_cache_day_us(void);
+uint64_t rtc_cache_epoch_ms(void);
+void rtc_cache_invalidate(void);
+
+#endif /* INC_RTC_CACHE_H_ */
@@ -0,0 +1,52 @@
+/*
+ * rtc_report.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_RTC_REPORT_H_
+#define INC_RTC_REPORT_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/* Report period range in seconds */
+#define RTC_REPORT_PERIOD_MIN	1
+#define RTC_REPORT_PERIOD_MAX	86400		/* 24 hours */
+
+/* Max number of concurrent subscriptions */
+#ifndef RTC_REPORT_SUBS_MAX
+#define RTC_REPORT_SUBS_MAX		8
+#endif
+
+/* Timing wheel - 3 levels of 64 slots cover 2^18 seconds (> RTC_REPORT_PERIOD_MAX) */
+#define RTC_WHEEL_BITS			6
+#define RTC_WHEEL_SLOTS			(1 << RTC_WHEEL_BITS)
+#define RTC_WHEEL_LEVELS		3
+
+/* Report formats */
+typedef enum{
+	RTC_REPORT_FMT_TIME,		/* time and date line */
+	RTC_REPORT_FMT_EPOCH,		/* heartbeat - Unix time in milliseconds */
+	RTC_REPORT_FMT_SUMMARY,		/* report statistics summary */
+	RTC_REPORT_FMT_NUM
+}rtc_report_fmt_t;
+
+/* Report statistics */
+typedef struct{
+	uint32_t events;		/* wakeup events (seconds) */
+	uint32_t missed;		/* events merged while the previous ones were still pending */
+	uint32_t reports;		/* reports printed */
+	uint32_t dropped;		/* reports lost - no message block or the print queue was full */
+	uint32_t subs;			/* active subscriptions */
+}rtc_report_stats_t;
+
+extern rtc_report_stats_t rtc_report_stats;
+
+int32_t rtc_report_subscribe(uint32_t period, rtc_report_fmt_t fmt);
+void rtc_report_unsubscribe(int32_t id);
+
+void rtc_report_task_handler(void* params);
+
+#endif /* INC_RTC_REPORT_H_ */
@@ -0,0 +1,33 @@
+/*
+ * stack_mon.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_STACK_MON_H_
+#define INC_STACK_MON_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/*
+ * Task stack monitor.
+ * The idle hook samples the stack high-water mark of every task and keeps the minimum free space per task
+ * in a table in CCMRAM - the startup code does not initialize CCMRAM so the table survives a reset
+ * (e.g. after a stack overflow). The stack size of each task is recorded at creation by
+ * traceTASK_CREATE(). stack_mon_report() prints the usage and the recommended size, compare it with
+ * the static worst case of tools/stack_usage.py.
+ */
+
+#define STACK_MON_PERIOD_MS		5000	/* minimum sampling period - the idle hook samples while awake */
+#define STACK_MON_MARGIN_PCT	25		/* recommended size = max used + margin */
+#define STACK_MON_MAGIC			0x5354414BU
+
+void stack_mon_init(void);
+void stack_mon_sample(void);
+void stack_mon_idle(void);
+void stack_mon_overflow(const char* name);
+void stack_mon_report(TickType_t timeout);
+
+#endif /* INC_STACK_MON_H_ */
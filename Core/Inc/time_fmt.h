@@ -0,0 +1,33 @@
+/*
+ * time_fmt.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_TIME_FMT_H_
+#define INC_TIME_FMT_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/* Max lengths written by the field formatters (no null termination) */
+#define TIME_FMT_U32_MAX		10		/* "4294967295" */
+#define TIME_FMT_TIME_MAX		13		/* "HH:MM:SS [AM]" */
+#define TIME_FMT_DATE_MAX		10		/* "DD-MM-YYYY" */
+#define TIME_FMT_WEEKDAY_MAX	3		/* "Sun" */
+
+/* The formatters write at p and never at or after end (the buffer end) - a field that does not fit is
+ * truncated. They return the end of the written field. */
+char* time_fmt_str(char* p, const char* end, const char* str);
+char* time_fmt_chr(char* p, const char* end, char c);
+char* time_fmt_u2(char* p, const char* end, uint32_t value);
+char* time_fmt_u32(char* p, const char* end, uint32_t value);
+char* time_fmt_u32_pad(char* p, const char* end, uint32_t value, uint32_t width);
+char* time_fmt_u32_align(char* p, const char* end, uint32_t value, uint32_t width);
+
+char* time_fmt_time(char* p, const char* end, const RTC_TimeTypeDef* sTime, uint32_t hour_format);
+char* time_fmt_date(char* p, const char* end, const RTC_DateTypeDef* sDate);
+char* time_fmt_weekday(char* p, const char* end, uint32_t weekday);
+
+#endif /* INC_TIME_FMT_H_ */
@@ -0,0 +1,50 @@
+/*
+ * uart_rx.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_UART_RX_H_
+#define INC_UART_RX_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "FreeRTOS.h"
+#include "ring_buff.h"
+
+/* Size of the DMA circular reception buffer (bytes).
+ * The HT/TC events split it in halves, so a burst is delivered at least every
+ * UART_RX_DMA_BUFF_SIZE/2 bytes even when the line never goes idle. */
+#define UART_RX_DMA_BUFF_SIZE	128
+
+/* Size of the input ring between the RX ISR and the command handling task (bytes, power of 2) - dozens of
+ * pipelined binary requests (up to COBS_ENC_MAX(PROTO_FRAME_MAX) + 2 bytes each) */
+#define UART_RX_RING_SIZE		1024
+
+#if (UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1))
+#error "UART_RX_RING_SIZE must be a power of 2"
+#endif
+
+/* A contiguous part of the DMA buffer that holds new received data */
+typedef struct{
+	const uint8_t* data;
+	uint32_t len;
+}uart_rx_span_t;
+
+/* Reception statistics */
+typedef struct{
+	uint32_t bursts;		/* number of delivered chunks (HT/TC/IDLE events with new data) */
+	uint32_t bytes;			/* number of received bytes */
+	uint32_t dropped;		/* bytes dropped - input ring was full */
+	uint32_t errors;		/* UART errors (overrun, noise, framing) */
+}uart_rx_stats_t;
+
+extern uart_rx_stats_t uart_rx_stats;
+extern ring_buff_t uart_rx_ring;	/* Input data ring */
+extern volatile TickType_t uart_rx_last_tick;	/* Tick count of the last received burst */
+
+HAL_StatusTypeDef uart_rx_start(UART_HandleTypeDef* huart);
+uint32_t uart_rx_spans(uint32_t* tail, uint32_t head, const uint8_t* buff, uint32_t size, uart_rx_span_t spans[2]);
+
+#endif /* INC_UART_RX_H_ */
@@ -0,0 +1,36 @@
+/*
+ * uart_tx.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef INC_UART_TX_H_
+#define INC_UART_TX_H_
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/* Size of each of the two DMA transmission buffers (bytes) */
+#define UART_TX_BUFF_SIZE		256
+
+/* Max time to wait for a DMA transfer to complete before it is aborted (ms) */
+#define UART_TX_TIMEOUT_MS		500
+
+/* Transmission statistics */
+typedef struct{
+	uint32_t messages;		/* number of transmitted messages */
+	uint32_t bytes;			/* number of transmitted bytes */
+	uint32_t transfers;		/* number of DMA transfers - messages are coalesced */
+	uint32_t busy_ticks;	/* time the line was busy (RTOS ticks) */
+	uint32_t q_depth_max;	/* high-water mark of the print queue */
+	uint32_t errors;		/* aborted transfers and failed starts */
+	uint32_t dropped;		/* bytes not sent - a transfer that failed to start */
+}uart_tx_stats_t;
+
+extern uart_tx_stats_t uart_tx_stats;
+
+void uart_tx_write(const uint8_t* data, uint32_t len);
+void uart_tx_flush(void);
+
+#endif /* INC_UART_TX_H_ */
@@ -0,0 +1,214 @@
+/*
+ * ao.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "ao.h"
+
+/* Registered active objects - priority order */
+static ao_t* ao_table[AO_MAX];
+static uint32_t ao_count;
+
+/* The dispatcher task - NULL until ao_run() */
+static TaskHandle_t ao_dispatcher;
+
+/**
+ * @brief This function updates the queue high-water mark after a post
+ *
+ * @note Call in a critical section - the tasks and the interrupts post
+ * */
+static void ao_depth_update(ao_t* me, uint32_t depth){
+	if(depth > me->stats.depth_max){
+		me->stats.depth_max = depth;
+	}
+}
+
+/**
+ * @brief This function creates the event queue of an active object and registers it
+ *
+ * @param me		The active object
+ * @param name		Name (reports)
+ * @param handler	Event handler
+ * @param storage	Queue storage - AO_QUEUE_STORAGE(len) bytes
+ * @param len		Queue length (events)
+ *
+ * @note Call before the scheduler starts, in priority order (highest first)
+ * */
+void ao_start(ao_t* me, const char* name, ao_handler_t handler, uint8_t* storage, uint32_t len){
+
+	configASSERT(ao_count < AO_MAX);
+
+	me->name = name;
+	me->handler = handler;
+	memset(&me->stats, 0, sizeof(me->stats));
+
+	me->queue = xQueueCreateStatic(len, sizeof(ao_event_t), storage, &me->queue_struct);
+	configASSERT(me->queue);
+
+	ao_table[ao_count++] = me;
+}
+
+/**
+ * @brief This function posts an event to an active object
+ *
+ * @param me	The active object
+ * @param e		The event (copied)
+ *
+ * @return pdTRUE if the event was queued
+ *
+ * @note Never blocks - also called by the handlers, which run in the dispatcher task
+ * */
+BaseType_t ao_post(ao_t* me, const ao_event_t* e){
+	ao_event_t ev = *e;
+
+	ev.stamp = DWT->CYCCNT;
+
+	if(xQueueSend(me->queue, &ev, 0) != pdTRUE){
+		taskENTER_CRITICAL();
+		me->stats.dropped++;
+		taskEXIT_CRITICAL();
+		return pdFALSE;
+	}
+
+	taskENTER_CRITICAL();
+	ao_depth_update(me, uxQueueMessagesWaiting(me->queue));
+	taskEXIT_CRITICAL();
+
+	if(ao_dispatcher){
+		xTaskNotifyGive(ao_dispatcher);
+	}
+
+	return pdTRUE;
+}
+
+/**
+ * @brief This function posts an event to an active object from an interrupt
+ *
+ * @param woken Set to pdTRUE when a context switch is required
+ * */
+BaseType_t ao_post_from_isr(ao_t* me, const ao_event_t* e, BaseType_t* woken){
+	ao_event_t ev = *e;
+	UBaseType_t mask;
+
+	ev.stamp = DWT->CYCCNT;
+
+	if(xQueueSendFromISR(me->queue, &ev, woken) != pdTRUE){
+		mask = taskENTER_CRITICAL_FROM_ISR();
+		me->stats.dropped++;
+		taskEXIT_CRITICAL_FROM_ISR(mask);
+		return pdFALSE;
+	}
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+	ao_depth_update(me, uxQueueMessagesWaitingFromISR(me->queue));
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+
+	if(ao_dispatcher){
+		vTaskNotifyGiveFromISR(ao_dispatcher, woken);
+	}
+
+	return pdTRUE;
+}
+
+/**
+ * @brief This function runs one event of the highest priority active object
+ *
+ * @return pdFALSE if all the queues are empty
+ * */
+static BaseType_t ao_dispatch(void){
+	ao_event_t e;
+	ao_t* me;
+	uint32_t start, lat, run;
+	uint32_t i;
+
+	for(i = 0; i < ao_count; i++){
+		me = ao_table[i];
+		if(xQueueReceive(me->queue, &e, 0) != pdTRUE){
+			continue;
+		}
+
+		start = DWT->CYCCNT;
+		me->handler(me, &e);
+		run = DWT->CYCCNT - start;
+		lat = start - e.stamp;
+
+		me->stats.events++;
+		me->stats.lat_sum += lat;
+		if(lat > me->stats.lat_max){
+			me->stats.lat_max = lat;
+		}
+		if(run > me->stats.run_max){
+			me->stats.run_max = run;
+		}
+
+		return pdTRUE;
+	}
+
+	return pdFALSE;
+}
+
+/**
+ * @brief This function is the dispatcher loop - runs the active objects, never returns
+ *
+ * @note The dispatcher task body. Waits for a post when all the queues are empty.
+ * */
+void ao_run(void){
+
+	ao_dispatcher = xTaskGetCurrentTaskHandle();
+
+	while(1){
+		// The events posted before the dispatcher started are handled first
+		while(ao_dispatch());
+
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
+
+/**
+ * @brief This function prints the active objects statistics to the console
+ *
+ * @param timeout Queue send timeout
+ *
+ * @note The cycles are converted with the current core clock
+ * */
+void ao_report(TickType_t timeout){
+	uint32_t mhz = SystemCoreClock / 1000000U;
+	ao_stats_t stats;
+	uint32_t i;
+	char* msg;
+	char* p;
+	char* end;
+
+	queue_send_msg("AO       Events  Depth  Drop  Avg us  Max us  Run us\n", timeout);
+
+	for(i = 0; i < ao_count; i++){
+		taskENTER_CRITICAL();
+		stats = ao_table[i]->stats;
+		taskEXIT_CRITICAL();
+
+		msg = msg_pool_alloc();
+		if(msg == NULL){
+			return;
+		}
+
+		// Truncated at the block end, room for the new line
+		end = msg + MSG_POOL_BLOCK_SIZE - 1;
+		p = time_fmt_str(msg, end, ao_table[i]->name);
+		while(p < msg + 8){
+			*p++ = ' ';
+		}
+		p = time_fmt_u32_align(p, end, stats.events, 7);
+		p = time_fmt_u32_align(p, end, stats.depth_max, 7);
+		p = time_fmt_u32_align(p, end, stats.dropped, 6);
+		p = time_fmt_u32_align(p, end, stats.events ? (uint32_t)(stats.lat_sum / stats.events) / mhz : 0, 8);
+		p = time_fmt_u32_align(p, end, stats.lat_max / mhz, 8);
+		p = time_fmt_u32_align(p, end, stats.run_max / mhz, 8);
+		*p++ = '\n';
+
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+	}
+}
@@ -0,0 +1,95 @@
+/*
+ * app_hsm.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "app_hsm.h"
+
+/* Menus */
+static const char* const menu_msg = "\n=====================\n"
+									"|\tMENU\t\t|\n"
+									"=====================\n"
+									"LED effect\t--> 0\n"
+									"Date and time\t--> 1\n"
+									"Exit\t\t--> 2\n"
+									"CPU usage\t--> stats\n"
+									"Stack usage\t--> stack\n"
+									"Heap usage\t--> heap\n"
+									"Sleep stats\t--> power\n"
+									"Clock profile\t--> clock perf|balanced|low|show\n"
+									"Event latency\t--> ao\n"
+									"Enter your choice here: ";
+
+static const char* const led_msg = "=====================\n"
+								   "|\tLEDs\t\t|\n"
+								   "=====================\n"
+								   "Options: exit, e1, e2, e3, e4\n"
+								   "Enter your choice here: ";
+
+static const char* const rtc_hdr_msg = "=====================\n"
+									   "|\tRTC\t\t|\n"
+									   "=====================\n";
+
+static const char* const rtc_menu_msg = "Configure time\t\t--> 0\n"
+										"Configure date\t\t--> 1\n"
+										"Enable reporting\t--> 2\n"
+										"Exit\t\t\t--> 3\n"
+										"Debug\t\t\t--> 4\n"
+										"Set date&time\t\t--> set YYYY-MM-DDTHH:MM:SS\n"
+										"Add report\t\t--> sub <1-86400> <time|epoch|summary>\n"
+										"Remove report\t\t--> unsub <id>\n"
+										"Enter your choice here: ";
+
+/**
+ * @brief This function is the Main Menu entry action - shows the menu
+ * */
+void menu_entry(void){
+	queue_send_msg(menu_msg, portMAX_DELAY);
+}
+
+/**
+ * @brief This function is the LEDs menu entry action - shows the options
+ * */
+void leds_entry(void){
+	queue_send_msg(led_msg, portMAX_DELAY);
+}
+
+/**
+ * @brief This function is the RTC menu entry action - shows the menu
+ * */
+void rtc_entry(void){
+	queue_send_msg(rtc_hdr_msg, portMAX_DELAY);
+	queue_send_msg(rtc_menu_msg, portMAX_DELAY);
+}
+
+/* Console states - the value prompts are children of the RTC menu */
+static const hsm_state_t app_states[sNum] = {
+	[sMainMenu]      = {HSM_NONE,  menu_entry, NULL},
+	[sMainIdle]      = {sMainMenu, NULL,       NULL},
+	[sLedEffect]     = {HSM_NONE,  leds_entry, leds_stop},
+	[sRtcMenu]       = {HSM_NONE,  rtc_entry,  NULL},
+	[sRtcTimeConfig] = {sRtcMenu,  NULL,       NULL},
+	[sRtcDateConfig] = {sRtcMenu,  NULL,       NULL},
+	[sRtcReport]     = {sRtcMenu,  NULL,       NULL},
+};
+
+/* Console transitions - the children inherit the transitions of the parent */
+static const hsm_transition_t app_transitions[] = {
+	{sMainMenu,  evLeds,   sLedEffect},
+	{sMainMenu,  evRtc,    sRtcMenu},
+	{sMainMenu,  evIdle,   sMainIdle},
+	{sMainMenu,  evDone,   sMainMenu},		/* also any input while idle */
+	{sLedEffect, evBack,   sMainMenu},
+	{sRtcMenu,   evBack,   sMainMenu},
+	{sRtcMenu,   evTime,   sRtcTimeConfig},
+	{sRtcMenu,   evDate,   sRtcDateConfig},
+	{sRtcMenu,   evReport, sRtcReport},
+	{sRtcMenu,   evDone,   sRtcMenu},		/* also the end of a value prompt */
+};
+
+const hsm_def_t app_hsm_def = {
+	app_states, app_transitions, sNum, evNum,
+	sizeof(app_transitions) / sizeof(app_transitions[0]), sMainMenu
+};
@@ -0,0 +1,269 @@
+/*
+ * clk_profile.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "clk_profile.h"
+
+/* Profile configuration */
+typedef struct{
+	const char* name;
+	uint32_t hse;				/* RCC_HSE_ON / RCC_HSE_OFF */
+	uint32_t pll;				/* RCC_PLL_ON / RCC_PLL_OFF - the PLL source is the HSE (8 MHz) */
+	uint32_t pllm, plln, pllp, pllq;	/* VCO input 2 MHz */
+	uint32_t sysclk;			/* RCC_SYSCLKSOURCE_x */
+	uint32_t apb1, apb2;		/* RCC_HCLK_DIVx - APB1 <= 42 MHz, APB2 <= 84 MHz */
+	uint32_t latency;			/* FLASH_LATENCY_x */
+	uint32_t hclk_hz;
+	uint32_t pclk1_hz;
+}clk_profile_cfg_t;
+
+static const clk_profile_cfg_t clk_profiles[CLK_PROFILE_NUM] = {
+	[CLK_PROFILE_PERF] = {
+		"perf", RCC_HSE_ON, RCC_PLL_ON, 4, 168, RCC_PLLP_DIV2, 7,
+		RCC_SYSCLKSOURCE_PLLCLK, RCC_HCLK_DIV4, RCC_HCLK_DIV2, FLASH_LATENCY_5, 168000000, 42000000
+	},
+	[CLK_PROFILE_BALANCED] = {
+		"balanced", RCC_HSE_ON, RCC_PLL_ON, 4, 100, RCC_PLLP_DIV2, 5,
+		RCC_SYSCLKSOURCE_PLLCLK, RCC_HCLK_DIV4, RCC_HCLK_DIV2, FLASH_LATENCY_3, 100000000, 25000000
+	},
+	[CLK_PROFILE_LOW] = {
+		"low", RCC_HSE_OFF, RCC_PLL_OFF, 0, 0, 0, 0,
+		RCC_SYSCLKSOURCE_HSI, RCC_HCLK_DIV1, RCC_HCLK_DIV1, FLASH_LATENCY_0, 16000000, 16000000
+	},
+};
+
+/* The port SysTick setup - recomputes the tick and the tickless idle constants from SystemCoreClock */
+extern void vPortSetupTimerInterrupt(void);
+
+static clk_profile_t clk_profile_current;
+static uint32_t clk_profile_failures;		/* switches that fell back to CLK_PROFILE_LOW */
+
+/**
+ * @brief This function computes the APB1 timers clock (TIM7)
+ *
+ * @note The timers run at twice PCLK1 when the APB1 prescaler is not 1
+ * */
+static uint32_t clk_apb1_timer_hz(uint32_t hclk, uint32_t pclk1){
+	return (pclk1 == hclk) ? pclk1 : 2 * pclk1;
+}
+
+/**
+ * @brief This function programs the oscillators, the PLL and the bus clocks of a profile
+ *
+ * @return HAL_OK, HAL_ERROR / HAL_TIMEOUT when the HSE or the PLL did not start (running on the HSI)
+ *
+ * @note Runs with the interrupts that use the kernel masked - the HAL time base (TIM6) still runs
+ * */
+static HAL_StatusTypeDef clk_profile_apply(const clk_profile_cfg_t* cfg){
+	RCC_OscInitTypeDef osc = {0};
+	RCC_ClkInitTypeDef clk = {0};
+	HAL_StatusTypeDef status;
+
+	// Run from the HSI while the PLL is reconfigured (the wait states are kept until the new clock is set)
+	clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+	clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+	clk.APB1CLKDivider = RCC_HCLK_DIV1;
+	clk.APB2CLKDivider = RCC_HCLK_DIV1;
+
+	status = HAL_RCC_ClockConfig(&clk, __HAL_FLASH_GET_LATENCY());
+	if(status != HAL_OK){
+		return status;
+	}
+
+	// The LSI (RTC) and the HSI are not touched
+	osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+	osc.HSEState = cfg->hse;
+	osc.PLL.PLLState = cfg->pll;
+	if(cfg->pll == RCC_PLL_ON){
+		osc.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+		osc.PLL.PLLM = cfg->pllm;
+		osc.PLL.PLLN = cfg->plln;
+		osc.PLL.PLLP = cfg->pllp;
+		osc.PLL.PLLQ = cfg->pllq;
+	}
+
+	status = HAL_RCC_OscConfig(&osc);
+	if(status != HAL_OK){
+		return status;
+	}
+
+	clk.SYSCLKSource = cfg->sysclk;
+	clk.APB1CLKDivider = cfg->apb1;
+	clk.APB2CLKDivider = cfg->apb2;
+
+	return HAL_RCC_ClockConfig(&clk, cfg->latency);
+}
+
+/**
+ * @brief This function switches the clock, falls back to CLK_PROFILE_LOW when the switch fails
+ * */
+static HAL_StatusTypeDef clk_profile_switch(clk_profile_t profile){
+	HAL_StatusTypeDef status;
+
+	status = clk_profile_apply(&clk_profiles[profile]);
+	if(status != HAL_OK){
+		// The HSI profile does not depend on external parts
+		profile = CLK_PROFILE_LOW;
+		clk_profile_failures++;
+		if(clk_profile_apply(&clk_profiles[profile]) != HAL_OK){
+			Error_Handler();
+		}
+	}
+
+	clk_profile_current = profile;
+
+	return status;
+}
+
+/**
+ * @brief This function adapts the peripherals to the new bus clocks
+ *
+ * @param hclk	HCLK before the switch
+ * @param timer	APB1 timers clock before the switch
+ * */
+static void clk_profile_rederive(uint32_t hclk, uint32_t timer){
+	const clk_profile_cfg_t* cfg = &clk_profiles[clk_profile_current];
+	uint32_t tim7_hz;
+
+	// Console baud rate
+	huart2.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK1Freq(), huart2.Init.BaudRate);
+
+	// TIM7 counter clock - the LED effects period (a running timer loads the prescaler at the next update)
+	tim7_hz = timer / (htim7.Instance->PSC + 1);
+	htim7.Init.Prescaler = clk_apb1_timer_hz(cfg->hclk_hz, cfg->pclk1_hz) / tim7_hz - 1;
+	htim7.Instance->PSC = htim7.Init.Prescaler;
+	if((htim7.Instance->CR1 & TIM_CR1_CEN) == 0){
+		htim7.Instance->EGR = TIM_EGR_UG;
+		__HAL_TIM_CLEAR_FLAG(&htim7, TIM_FLAG_UPDATE);
+	}
+
+	// Kernel tick - set up by the scheduler start otherwise
+	if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED){
+		vPortSetupTimerInterrupt();
+	}
+
+	// SWO bit rate - the trace port clock is HCLK
+	if(CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk){
+		TPI->ACPR = ((TPI->ACPR + 1) * (cfg->hclk_hz / 1000) + hclk / 2000) / (hclk / 1000) - 1;
+	}
+}
+
+/**
+ * @brief This function replaces the boot clock by CLK_PROFILE_BOOT
+ *
+ * @note Call after the peripherals are initialized and before the scheduler starts
+ * */
+void clk_profile_init(void){
+	uint32_t hclk = HAL_RCC_GetHCLKFreq();
+	uint32_t timer = clk_apb1_timer_hz(hclk, HAL_RCC_GetPCLK1Freq());
+
+	clk_profile_switch(CLK_PROFILE_BOOT);
+	clk_profile_rederive(hclk, timer);
+}
+
+/**
+ * @brief This function switches the clock profile
+ *
+ * @param profile The new profile
+ *
+ * @return HAL_OK, HAL_ERROR when the profile did not start (CLK_PROFILE_LOW is used)
+ *
+ * @note Task context. Waits up to CLK_PROFILE_DRAIN_MS for the console output to drain.
+ * */
+HAL_StatusTypeDef clk_profile_set(clk_profile_t profile){
+	const clk_profile_cfg_t* cfg;
+	HAL_StatusTypeDef status;
+	uint32_t wait;
+
+	configASSERT(profile < CLK_PROFILE_NUM);
+
+	// A baud rate change corrupts a frame in flight
+	for(wait = 0; wait < CLK_PROFILE_DRAIN_MS; wait++){
+		if(uxQueueMessagesWaiting(q_print) == 0 && huart2.gState == HAL_UART_STATE_READY &&
+				(huart2.Instance->SR & USART_SR_TC)){
+			break;
+		}
+		vTaskDelay(pdMS_TO_TICKS(1));
+	}
+
+	taskENTER_CRITICAL();
+
+	cfg = &clk_profiles[clk_profile_current];
+	status = clk_profile_switch(profile);
+	clk_profile_rederive(cfg->hclk_hz, clk_apb1_timer_hz(cfg->hclk_hz, cfg->pclk1_hz));
+
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+/**
+ * @brief This function restores the clock of the current profile after STOP mode (the HSI is selected)
+ *
+ * @note Call with the interrupts that use the kernel masked (BASEPRI) and PRIMASK clear - the HSE and
+ * 		 PLL start-up waits time out on the HAL time base
+ * */
+void clk_profile_restore(void){
+	const clk_profile_cfg_t* cfg = &clk_profiles[clk_profile_current];
+
+	if(clk_profile_switch(clk_profile_current) != HAL_OK){
+		clk_profile_rederive(cfg->hclk_hz, clk_apb1_timer_hz(cfg->hclk_hz, cfg->pclk1_hz));
+	}
+}
+
+/**
+ * @brief This function returns the current clock profile
+ * */
+clk_profile_t clk_profile_get(void){
+	return clk_profile_current;
+}
+
+/**
+ * @brief This function prints the current clock profile and the bus clocks to the console
+ *
+ * @param timeout Queue send timeout
+ * */
+void clk_profile_report(TickType_t timeout){
+	char* msg;
+	char* p;
+	char* end;
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	// Truncated at the block end, room for the new line
+	end = msg + MSG_POOL_BLOCK_SIZE - 1;
+	p = time_fmt_str(msg, end, "Clock ");
+	p = time_fmt_str(p, end, clk_profiles[clk_profile_current].name);
+	p = time_fmt_str(p, end, ", flash wait states ");
+	p = time_fmt_u32(p, end, __HAL_FLASH_GET_LATENCY());
+	if(clk_profile_failures){
+		p = time_fmt_str(p, end, ", failed ");
+		p = time_fmt_u32(p, end, clk_profile_failures);
+	}
+	*p++ = '\n';
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = time_fmt_str(msg, end, "HCLK ");
+	p = time_fmt_u32(p, end, HAL_RCC_GetHCLKFreq());
+	p = time_fmt_str(p, end, " PCLK1 ");
+	p = time_fmt_u32(p, end, HAL_RCC_GetPCLK1Freq());
+	p = time_fmt_str(p, end, " PCLK2 ");
+	p = time_fmt_u32(p, end, HAL_RCC_GetPCLK2Freq());
+	p = time_fmt_str(p, end, " Hz\n");
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+}
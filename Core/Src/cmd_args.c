@@ -0,0 +1,181 @@
+/*
+ * cmd_args.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stddef.h>
+#include "cmd_args.h"
+
+/* Error messages - indexed by args_err_t */
+static const char* const args_err_msgs[] = {
+	"ok\n",
+	"error: missing argument\n",
+	"error: too many arguments\n",
+	"error: not a number\n",
+	"error: number too large\n",
+	"error: value out of range\n",
+	"error: unknown option\n",
+};
+
+/**
+ * @brief This function parses a decimal integer token
+ *
+ * @return ARGS_OK, ARGS_ERR_NOT_NUMBER or ARGS_ERR_OVERFLOW
+ * */
+static args_err_t args_parse_int(const char* tok, uint32_t len, int32_t* num){
+	uint32_t value = 0;
+	uint32_t limit = INT32_MAX;
+	uint32_t digit;
+	uint32_t i = 0;
+	int neg = 0;
+
+	if(tok[0] == '-' || tok[0] == '+'){
+		neg = (tok[0] == '-');
+		limit += neg;		/* |INT32_MIN| */
+		i++;
+	}
+
+	if(i == len){
+		return ARGS_ERR_NOT_NUMBER;
+	}
+
+	for(; i < len; i++){
+		digit = (uint32_t)(tok[i] - '0');
+		if(digit > 9){
+			return ARGS_ERR_NOT_NUMBER;
+		}
+
+		if(value > (limit - digit) / 10){
+			return ARGS_ERR_OVERFLOW;
+		}
+		value = value * 10 + digit;
+	}
+
+	*num = neg ? (int32_t)(0 - value) : (int32_t)value;
+
+	return ARGS_OK;
+}
+
+/**
+ * @brief This function folds an ASCII letter to lower case - the other characters are not changed
+ * */
+static inline char args_lower(char ch){
+	return (ch >= 'A' && ch <= 'Z') ? (char)(ch | 0x20) : ch;
+}
+
+/**
+ * @brief This function matches a token to a keyword list (case insensitive)
+ *
+ * @return ARGS_OK or ARGS_ERR_KEYWORD
+ * */
+static args_err_t args_parse_enum(const char* tok, uint32_t len, const char* const* keywords, uint32_t* idx){
+	uint32_t k, i;
+	const char* kw;
+
+	for(k = 0; keywords[k]; k++){
+		kw = keywords[k];
+
+		for(i = 0; i < len && kw[i]; i++){
+			if(args_lower(tok[i]) != args_lower(kw[i])){
+				break;
+			}
+		}
+
+		if(i == len && kw[i] == '\0'){
+			*idx = k;
+			return ARGS_OK;
+		}
+	}
+
+	return ARGS_ERR_KEYWORD;
+}
+
+/**
+ * @brief This function splits a line to space separated arguments and converts them by the schema
+ *
+ * @param line		Arguments line (not null terminated)
+ * @param len		Line length
+ * @param spec		Arguments schema
+ * @param nspec		Number of arguments in the schema
+ * @param out		Parsed arguments (nspec entries)
+ * @param err_pos	Optional - offset of the failing token in the line
+ *
+ * @return ARGS_OK or the error of the first invalid argument
+ *
+ * @note Single pass over the line, no allocation and no copy (strings are slices of the line)
+ * */
+args_err_t args_parse(const char* line, uint32_t len, const arg_spec_t* spec, uint32_t nspec,
+					  arg_val_t* out, uint32_t* err_pos){
+	args_err_t err = ARGS_OK;
+	uint32_t pos = 0;
+	uint32_t start;
+	uint32_t n = 0;
+
+	while(1){
+		// Skip the separators
+		while(pos < len && line[pos] == ' '){
+			pos++;
+		}
+		if(pos == len){
+			break;
+		}
+
+		// Find the token end
+		start = pos;
+		while(pos < len && line[pos] != ' '){
+			pos++;
+		}
+
+		if(n == nspec){
+			err = ARGS_ERR_EXTRA;
+			break;
+		}
+
+		out[n].type = spec[n].type;
+
+		switch(spec[n].type){
+			case ARG_INT:
+				err = args_parse_int(&line[start], pos - start, &out[n].num);
+				if(err == ARGS_OK && (out[n].num < spec[n].min || out[n].num > spec[n].max)){
+					err = ARGS_ERR_RANGE;
+				}
+				break;
+			case ARG_ENUM:
+				err = args_parse_enum(&line[start], pos - start, spec[n].keywords, &out[n].idx);
+				break;
+			case ARG_STR:
+				out[n].str.ptr = &line[start];
+				out[n].str.len = pos - start;
+				break;
+		}
+
+		if(err != ARGS_OK){
+			break;
+		}
+		n++;
+	}
+
+	if(err == ARGS_OK && n < nspec){
+		err = ARGS_ERR_MISSING;
+		start = pos;
+	}
+
+	if(err != ARGS_OK && err_pos){
+		*err_pos = start;
+	}
+
+	return err;
+}
+
+/**
+ * @brief This function returns the printable message of a parse error
+ * */
+const char* args_err_msg(args_err_t err){
+
+	if((uint32_t)err >= sizeof(args_err_msgs) / sizeof(args_err_msgs[0])){
+		return args_err_msgs[ARGS_ERR_NOT_NUMBER];
+	}
+
+	return args_err_msgs[err];
+}
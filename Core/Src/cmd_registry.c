@@ -0,0 +1,134 @@
+/*
+ * cmd_registry.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "cmd_registry.h"
+
+/* The registered subsystem tables */
+static const cmd_entry_t* const cmd_tables[] = {
+	menu_cmds,
+	leds_cmds,
+	rtc_cmds,
+};
+
+/* Perfect hash slots - built once from the const tables with CMD_HASH_SEED */
+static const cmd_entry_t* cmd_slots[CMD_HASH_SIZE];
+static uint32_t cmd_hash_seed;
+
+/**
+ * @brief This function hashes a command name within its group (seeded FNV-1a)
+ * */
+static uint32_t cmd_hash(uint32_t seed, cmd_group_t group, const char* name, uint32_t len){
+	uint32_t h = (seed ^ ((uint32_t)group * 0x9E3779B1U)) * 16777619U;
+	uint32_t i;
+
+	for(i = 0; i < len; i++){
+		h = (h ^ (uint8_t)name[i]) * 16777619U;
+	}
+
+	return (h ^ (h >> 16)) & (CMD_HASH_SIZE - 1);
+}
+
+/**
+ * @brief This function places all the commands with the given seed
+ *
+ * @return pdTRUE if there is no collision
+ *
+ * @note One pass over the command tables. The host test checks CMD_HASH_SEED and finds a new one.
+ * */
+BaseType_t cmd_registry_build(uint32_t seed){
+	const cmd_entry_t* entry;
+	uint32_t t, slot;
+
+	memset(cmd_slots, 0, sizeof(cmd_slots));
+	cmd_hash_seed = seed;
+
+	for(t = 0; t < sizeof(cmd_tables) / sizeof(cmd_tables[0]); t++){
+		for(entry = cmd_tables[t]; entry->name; entry++){
+			slot = cmd_hash(seed, entry->group, entry->name, strlen(entry->name));
+			if(cmd_slots[slot]){
+				return pdFALSE;
+			}
+			cmd_slots[slot] = entry;
+		}
+	}
+
+	return pdTRUE;
+}
+
+/**
+ * @brief This function builds the perfect hash of the command tables
+ *
+ * @note Call once before the scheduler starts
+ * */
+void cmd_registry_init(void){
+
+	// A collision - the commands changed, run the host test for a new CMD_HASH_SEED
+	if(cmd_registry_build(CMD_HASH_SEED) == pdFALSE){
+		configASSERT(0);
+	}
+}
+
+/**
+ * @brief This function finds a command
+ *
+ * @param group	The command group (menu)
+ * @param name	Command name (not null terminated)
+ * @param len	Command name length
+ *
+ * @return The command entry, NULL if not registered
+ *
+ * @note Constant time - one hash and one compare regardless of the number of commands
+ * */
+const cmd_entry_t* cmd_lookup(cmd_group_t group, const char* name, uint32_t len){
+	const cmd_entry_t* entry;
+
+	entry = cmd_slots[cmd_hash(cmd_hash_seed, group, name, len)];
+	if(entry == NULL || entry->group != group){
+		return NULL;
+	}
+
+	if(strncmp(entry->name, name, len) || entry->name[len] != '\0'){
+		return NULL;
+	}
+
+	return entry;
+}
+
+/**
+ * @brief This function executes a command line
+ *
+ * @param group	The command group (menu)
+ * @param line	Command line - "name [args]"
+ * @param len	Command line length
+ *
+ * @return The handler result, CMD_ERR_NOT_FOUND or CMD_ERR_ARGS(args_err_t)
+ * */
+int32_t cmd_dispatch(cmd_group_t group, const char* line, uint32_t len){
+	const cmd_entry_t* entry;
+	arg_val_t args[CMD_MAX_ARGS];
+	uint32_t name_len = 0;
+	args_err_t err;
+
+	while(name_len < len && line[name_len] != ' '){
+		name_len++;
+	}
+
+	entry = cmd_lookup(group, line, name_len);
+	if(entry == NULL){
+		return CMD_ERR_NOT_FOUND;
+	}
+
+	configASSERT(entry->nargs <= CMD_MAX_ARGS);
+
+	// Parse the arguments by the entry schema
+	err = args_parse(&line[name_len], len - name_len, entry->args, entry->nargs, args, NULL);
+	if(err != ARGS_OK){
+		return CMD_ERR_ARGS(err);
+	}
+
+	return (int32_t)entry->handler(entry->param, args);
+}
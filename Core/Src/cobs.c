@@ -0,0 +1,85 @@
+/*
+ * cobs.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdint.h>
+#include "cobs.h"
+
+/**
+ * @brief This function encodes a buffer
+ *
+ * @param in	Data
+ * @param len	Data length
+ * @param out	Encoded data - COBS_ENC_MAX(len) bytes, no delimiter is added
+ *
+ * @return The encoded length
+ * */
+uint32_t cobs_encode(const uint8_t* in, uint32_t len, uint8_t* out){
+	uint8_t* code = out;		/* the code byte of the current block */
+	uint8_t* p = out + 1;
+	uint8_t n = 1;
+
+	while(len--){
+		if(*in == 0){
+			*code = n;
+			code = p++;
+			n = 1;
+		}
+		else{
+			*p++ = *in;
+			// A full block has no trailing zero
+			if(++n == 0xFF){
+				*code = n;
+				code = p++;
+				n = 1;
+			}
+		}
+		in++;
+	}
+
+	*code = n;
+
+	return p - out;
+}
+
+/**
+ * @brief This function decodes a frame (without the delimiters)
+ *
+ * @param in	Encoded data
+ * @param len	Encoded length
+ * @param out	Decoded data
+ * @param size	Decoded data size
+ *
+ * @return The decoded length, -1 on a zero byte, a truncated block or a too long frame
+ * */
+int32_t cobs_decode(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t size){
+	uint32_t i = 0;
+	uint32_t n = 0;
+	uint8_t code, j;
+
+	while(i < len){
+		code = in[i++];
+		if(code == 0 || i + code - 1 > len){
+			return -1;
+		}
+
+		for(j = 1; j < code; j++){
+			if(in[i] == 0 || n == size){
+				return -1;
+			}
+			out[n++] = in[i++];
+		}
+
+		// Each block but a full one and the last is followed by a zero
+		if(code != 0xFF && i < len){
+			if(n == size){
+				return -1;
+			}
+			out[n++] = 0;
+		}
+	}
+
+	return n;
+}
@@ -0,0 +1,267 @@
+/*
+ * cpu_stats.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "semphr.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "lp_idle.h"
+#include "cpu_stats.h"
+
+/* Context switches per task (indexed by the task number) - counted by traceTASK_SWITCHED_IN() */
+uint32_t cpu_stats_switches[TRACE_TASKS_MAX];
+
+/* The 64 bits cycle counter - the high word counts the DWT CYCCNT wraps */
+static uint32_t cpu_cycles_high;
+static uint32_t cpu_cycles_last;
+
+/* Samples - the window base (the previous report, [cpu_base]) and now. Used under cpu_stats_lock. */
+typedef struct{
+	TaskStatus_t tasks[TRACE_TASKS_MAX];
+	uint32_t switches[TRACE_TASKS_MAX];
+	uint32_t count;
+	uint32_t total;				/* run time counter */
+	uint64_t cycles;			/* 64 bits cycle counter - detects a counter wrap */
+	uint32_t clock;				/* SystemCoreClock - the run time counter rate */
+	uint32_t stop_ms;			/* lp_idle time in STOP - the DWT does not count in STOP */
+}cpu_sample_t;
+
+static cpu_sample_t cpu_samples[2];
+static uint32_t cpu_base;
+
+static SemaphoreHandle_t cpu_stats_lock;
+static StaticSemaphore_t cpu_stats_lock_struct;
+
+/**
+ * @brief This function starts the DWT cycle counter
+ *
+ * @note Called by the kernel (portCONFIGURE_TIMER_FOR_RUN_TIME_STATS) when the scheduler starts
+ * */
+void cpu_stats_timer_init(void){
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	cpu_cycles_high = 0;
+	cpu_cycles_last = 0;
+}
+
+/**
+ * @brief This function reads the 64 bits cycle counter
+ *
+ * @note Any context. A wrap is detected as long as the counter is read at least once per
+ * 		 2^32 cycles - the tick hook reads it.
+ * */
+uint64_t cpu_stats_cycles(void){
+	UBaseType_t mask;
+	uint32_t now;
+	uint64_t cycles;
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+
+	now = DWT->CYCCNT;
+	if(now < cpu_cycles_last){
+		cpu_cycles_high++;
+	}
+	cpu_cycles_last = now;
+	cycles = ((uint64_t)cpu_cycles_high << 32) | now;
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+
+	return cycles;
+}
+
+/**
+ * @brief This function is the kernel run time counter (portGET_RUN_TIME_COUNTER_VALUE)
+ *
+ * @return The cycle counter scaled by CPU_STATS_SHIFT
+ * */
+uint32_t cpu_stats_counter(void){
+	return (uint32_t)(cpu_stats_cycles() >> CPU_STATS_SHIFT);
+}
+
+/**
+ * @brief This function formats a hundredths value as a percentage - "xxx.yy%"
+ * */
+static char* cpu_stats_fmt_pct(char* p, const char* end, uint32_t hundredths){
+	uint32_t whole = hundredths / 100;
+
+	if(whole < 100){
+		p = time_fmt_chr(p, end, ' ');
+	}
+	if(whole < 10){
+		p = time_fmt_chr(p, end, ' ');
+	}
+	p = time_fmt_u32(p, end, whole);
+	p = time_fmt_chr(p, end, '.');
+	p = time_fmt_u2(p, end, hundredths - whole * 100);
+	p = time_fmt_chr(p, end, '%');
+
+	return p;
+}
+
+/**
+ * @brief This function samples the tasks state and the context switch counters
+ *
+ * @note Call under cpu_stats_lock. The number of tasks is 0 if the table is too small.
+ * */
+static void cpu_stats_sample(cpu_sample_t* sample){
+
+	vTaskSuspendAll();
+	sample->count = uxTaskGetSystemState(sample->tasks, TRACE_TASKS_MAX, &sample->total);
+	memcpy(sample->switches, cpu_stats_switches, sizeof(sample->switches));
+	sample->cycles = cpu_stats_cycles();
+	sample->clock = SystemCoreClock;
+	sample->stop_ms = lp_idle_stats.stop_ms;
+	xTaskResumeAll();
+}
+
+/**
+ * @brief This function creates the samples lock
+ *
+ * @note Call before the scheduler starts. Nothing is sampled until the first report.
+ * */
+void cpu_stats_init(void){
+
+	cpu_stats_lock = xSemaphoreCreateMutexStatic(&cpu_stats_lock_struct);
+	configASSERT(cpu_stats_lock);
+}
+
+/**
+ * @brief This function converts run time counter units to us
+ * */
+static uint64_t cpu_stats_us(uint32_t run, uint32_t clock){
+	return ((uint64_t)run << CPU_STATS_SHIFT) / (clock / 1000000U);
+}
+
+/**
+ * @brief This function prints the CPU usage of the tasks to the console
+ *
+ * @param timeout Queue send timeout
+ *
+ * @note Samples on demand - the usage and the context switches are measured from the previous report
+ * 		 to now, the first report only starts the window. The time in STOP (lp_idle) is idle time. A
+ * 		 window across a clock profile switch or longer than the run time counter range restarts.
+ * */
+void cpu_stats_report(TickType_t timeout){
+	TaskHandle_t idle = xTaskGetIdleTaskHandle();
+	const cpu_sample_t* prev;
+	const cpu_sample_t* now;
+	const char* restart = NULL;
+	uint64_t window_us, run_us;
+	uint32_t i, j, num;
+	uint32_t run, pct;
+	uint32_t idle_pct = 0;
+	char* msg;
+	char* p;
+	char* end;
+
+	xSemaphoreTake(cpu_stats_lock, portMAX_DELAY);
+
+	prev = &cpu_samples[cpu_base];
+	now = &cpu_samples[cpu_base ^ 1];
+	cpu_stats_sample(&cpu_samples[cpu_base ^ 1]);
+
+	// The run time counter rate changed, or it wrapped more than once
+	if(prev->count == 0){
+		restart = "started";
+	}
+	else if(now->clock != prev->clock){
+		restart = "restarted (clock profile switch)";
+	}
+	else if(now->cycles - prev->cycles >= ((uint64_t)1 << (32 + CPU_STATS_SHIFT))){
+		restart = "restarted (too long)";
+	}
+
+	// The next window starts now
+	cpu_base ^= 1;
+
+	if(restart || now->count == 0){
+		xSemaphoreGive(cpu_stats_lock);
+
+		msg = msg_pool_alloc();
+		if(msg == NULL){
+			return;
+		}
+
+		end = msg + MSG_POOL_BLOCK_SIZE;
+		p = time_fmt_str(msg, end, "CPU window ");
+		p = time_fmt_str(p, end, restart ? restart : "skipped (tasks)");
+		p = time_fmt_str(p, end, ", show again\n");
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+		return;
+	}
+
+	// The DWT stops in STOP - the window is the counted run time plus the time in STOP
+	window_us = cpu_stats_us(now->total - prev->total, now->clock) + (uint64_t)(now->stop_ms - prev->stop_ms) * 1000;
+	if(window_us == 0){
+		xSemaphoreGive(cpu_stats_lock);
+		return;
+	}
+
+	queue_send_msg("Task         CPU%  Switches\n", timeout);
+
+	for(i = 0; i < now->count; i++){
+		// The same task in the older sample - a new task is measured from zero
+		run = now->tasks[i].ulRunTimeCounter;
+		for(j = 0; j < prev->count; j++){
+			if(prev->tasks[j].xTaskNumber == now->tasks[i].xTaskNumber){
+				run -= prev->tasks[j].ulRunTimeCounter;
+				break;
+			}
+		}
+
+		run_us = cpu_stats_us(run, now->clock);
+		if(now->tasks[i].xHandle == idle){
+			run_us += (uint64_t)(now->stop_ms - prev->stop_ms) * 1000;
+		}
+
+		pct = (uint32_t)(run_us * 10000 / window_us);
+		if(now->tasks[i].xHandle == idle){
+			idle_pct = pct;
+		}
+
+		num = now->tasks[i].xTaskNumber & (TRACE_TASKS_MAX - 1);
+
+		msg = msg_pool_alloc();
+		if(msg == NULL){
+			xSemaphoreGive(cpu_stats_lock);
+			return;
+		}
+
+		// Name (padded to configMAX_TASK_NAME_LEN), "xxx.yy%", switches
+		// Truncated at the block end, room for the new line
+		end = msg + MSG_POOL_BLOCK_SIZE - 1;
+		p = time_fmt_str(msg, end, now->tasks[i].pcTaskName);
+		while(p < msg + configMAX_TASK_NAME_LEN){
+			*p++ = ' ';
+		}
+		p = cpu_stats_fmt_pct(p, end, pct);
+		p = time_fmt_str(p, end, "  ");
+		p = time_fmt_u32(p, end, now->switches[num] - prev->switches[num]);
+		*p++ = '\n';
+
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+	}
+
+	xSemaphoreGive(cpu_stats_lock);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	// Idle xxx.yy% over <window> ms
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = time_fmt_str(msg, end, "Idle ");
+	p = cpu_stats_fmt_pct(p, end, idle_pct);
+	p = time_fmt_str(p, end, " over ");
+	p = time_fmt_u32(p, end, (uint32_t)(window_us / 1000));
+	p = time_fmt_str(p, end, " ms\n");
+
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+}
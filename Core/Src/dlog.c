@@ -0,0 +1,158 @@
+/*
+ * dlog.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdarg.h>
+#include "main.h"
+#include "dlog.h"
+
+#if (DLOG_RING_WORDS & (DLOG_RING_WORDS - 1))
+#error "DLOG_RING_WORDS must be a power of 2"
+#endif
+
+#define DLOG_RING_MASK		(DLOG_RING_WORDS - 1)
+
+/* Records ring - written by any context, drained by the idle task */
+static uint32_t dlog_ring[DLOG_RING_WORDS];
+static volatile uint32_t dlog_head;
+static volatile uint32_t dlog_tail;
+
+dlog_stats_t dlog_stats;
+
+/**
+ * @brief This function reserves ring space for a record
+ *
+ * @return The record start index, -1 if the ring is full
+ *
+ * @note Call in a critical section
+ * */
+static int32_t dlog_reserve(uint32_t words){
+	uint32_t head = dlog_head;
+
+	if(DLOG_RING_WORDS - (head - dlog_tail) < words){
+		dlog_stats.dropped++;
+		return -1;
+	}
+
+	dlog_head = head + words;
+	dlog_stats.records++;
+
+	return (int32_t)head;
+}
+
+/**
+ * @brief This function returns the record timestamp
+ *
+ * @return The tick count, 0 before the scheduler starts (the port interrupt priority check is not set up yet)
+ * */
+static uint32_t dlog_stamp(void){
+
+	if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED){
+		return 0;
+	}
+
+	return xTaskGetTickCountFromISR();
+}
+
+/**
+ * @brief This function writes a log record
+ *
+ * @param id	Format string ID (DLOG_FMT_ID)
+ * @param nargs	Number of 32 bits arguments (up to DLOG_MAX_ARGS)
+ *
+ * @note Use the DLOG() macro. Can be called from a task or an ISR.
+ * */
+void dlog_write(uint32_t id, uint32_t nargs, ...){
+	UBaseType_t mask;
+	va_list ap;
+	int32_t idx;
+	uint32_t i;
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+
+	idx = dlog_reserve(2 + nargs);
+	if(idx >= 0){
+		dlog_ring[idx & DLOG_RING_MASK] = DLOG_SYNC | (nargs << 20) | (id & DLOG_ID_MASK);
+		dlog_ring[(idx + 1) & DLOG_RING_MASK] = dlog_stamp();
+
+		va_start(ap, nargs);
+		for(i = 0; i < nargs; i++){
+			dlog_ring[(idx + 2 + i) & DLOG_RING_MASK] = va_arg(ap, uint32_t);
+		}
+		va_end(ap);
+	}
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief This function writes a log record with a data buffer
+ *
+ * @param id	Format string ID (DLOG_FMT_ID)
+ * @param data	Data to copy to the record
+ * @param len	Data length (truncated to DLOG_MAX_BUF)
+ *
+ * @note Use the DLOG_BUF() macro. Can be called from a task or an ISR.
+ * */
+void dlog_write_buf(uint32_t id, const void* data, uint32_t len){
+	const uint8_t* src = data;
+	UBaseType_t mask;
+	uint32_t word;
+	int32_t idx;
+	uint32_t i;
+
+	if(len > DLOG_MAX_BUF){
+		len = DLOG_MAX_BUF;
+	}
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+
+	idx = dlog_reserve(3 + (len + 3) / 4);
+	if(idx >= 0){
+		dlog_ring[idx & DLOG_RING_MASK] = DLOG_SYNC | (DLOG_NARGS_BUF << 20) | (id & DLOG_ID_MASK);
+		dlog_ring[(idx + 1) & DLOG_RING_MASK] = dlog_stamp();
+		dlog_ring[(idx + 2) & DLOG_RING_MASK] = len;
+
+		// Little endian words, zero padded
+		for(i = 0; i < len; i += 4){
+			word = src[i];
+			word |= (i + 1 < len) ? (uint32_t)src[i + 1] << 8 : 0;
+			word |= (i + 2 < len) ? (uint32_t)src[i + 2] << 16 : 0;
+			word |= (i + 3 < len) ? (uint32_t)src[i + 3] << 24 : 0;
+			dlog_ring[(idx + 3 + i / 4) & DLOG_RING_MASK] = word;
+		}
+	}
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief This function drains the ring to the ITM stimulus port
+ *
+ * @note Called from the idle hook - never waits for the ITM FIFO, returns when it is full.
+ * 		 The records are kept while the ITM (SWV trace) is disabled.
+ * */
+void dlog_drain(void){
+	uint32_t tail = dlog_tail;
+
+	if((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & (1U << DLOG_ITM_PORT)) == 0){
+		return;
+	}
+
+	while(tail != dlog_head){
+		// FIFO full
+		if(ITM->PORT[DLOG_ITM_PORT].u32 == 0){
+			break;
+		}
+
+		ITM->PORT[DLOG_ITM_PORT].u32 = dlog_ring[tail & DLOG_RING_MASK];
+		tail++;
+		dlog_stats.words++;
+	}
+
+	// Release the space after the words were read
+	__DMB();
+	dlog_tail = tail;
+}
@@ -0,0 +1,233 @@
+/*
+ * epoch.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "epoch.h"
+
+/*
+ * Unix time (seconds since 1970-01-01) <-> calendar conversion for 2000 - 2099.
+ * In this range every 4th year is a leap year (2000 is divisible by 400), so a 1461 days
+ * cycle covers the calendar. All the divisions are by constants and done by multiply and
+ * shift, the constants are exact for the whole range (up to 2^32 seconds).
+ */
+
+#define EPOCH_DAYS_2000		10957U		/* days from 1970-01-01 to 2000-01-01 */
+
+/* Days before each month in a common year (index 1 - 12) */
+static const uint16_t epoch_days_before[13] = {0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+/**
+ * @brief This function returns the number of days in a month
+ * */
+uint32_t epoch_month_days(uint32_t year, uint32_t month){
+	uint32_t days;
+
+	if(month == 12){
+		return 31;
+	}
+
+	days = epoch_days_before[month + 1] - epoch_days_before[month];
+
+	return days + (month == 2 && (year & 3) == 0);
+}
+
+/**
+ * @brief This function returns the day of the week
+ *
+ * @param days Days since 1970-01-01 (Thursday)
+ *
+ * @return RTC weekday - RTC_WEEKDAY_MONDAY (1) to RTC_WEEKDAY_SUNDAY (7)
+ * */
+uint32_t epoch_weekday(uint32_t days){
+	uint32_t x = days + 3;
+
+	// x % 7
+	return x - ((x * 74899U) >> 19) * 7 + 1;
+}
+
+/**
+ * @brief This function converts a date to days since 1970-01-01
+ *
+ * @param year	2000 - 2099
+ * @param month	1 - 12
+ * @param day	1 - 31
+ * */
+uint32_t epoch_days_from_civil(uint32_t year, uint32_t month, uint32_t day){
+	uint32_t yy = year - EPOCH_YEAR_MIN;
+
+	return EPOCH_DAYS_2000 + yy * 365 + ((yy + 3) >> 2) + epoch_days_before[month]
+		   + ((month > 2) & ((yy & 3) == 0)) + day - 1;
+}
+
+/**
+ * @brief This function converts days since 1970-01-01 to a date
+ *
+ * @param days	Days since 1970-01-01
+ * @param ct	Year, month, day and weekday are set
+ * */
+void epoch_civil_from_days(uint32_t days, civil_time_t* ct){
+	uint32_t quad, d4, yq, doy, leap, march, month;
+
+	ct->weekday = epoch_weekday(days);
+
+	days -= EPOCH_DAYS_2000;
+
+	// 4 years cycle - the first year is the leap year
+	quad = (days * 22967U) >> 25;								/* days / 1461 */
+	d4 = days - quad * 1461;
+	yq = (d4 >= 366) + (d4 >= 731) + (d4 >= 1096);
+	doy = d4 - yq * 365 - (yq != 0);
+	leap = (yq == 0);
+
+	march = (doy >= 59 + leap);
+	if(march){
+		// Months from March have a regular length pattern (31, 30, 31, 30, 31)
+		month = ((((doy - 59 - leap) * 5 + 2) * 857U) >> 17) + 3;	/* (d * 5 + 2) / 153 */
+	}
+	else{
+		month = 1 + (doy >= 31);
+	}
+
+	ct->year = EPOCH_YEAR_MIN + quad * 4 + yq;
+	ct->month = month;
+	ct->day = doy - (march & leap) - epoch_days_before[month] + 1;
+}
+
+/**
+ * @brief This function converts a date and time to Unix time
+ *
+ * @return Seconds since 1970-01-01 00:00:00
+ * */
+uint32_t epoch_from_civil(const civil_time_t* ct){
+
+	return epoch_days_from_civil(ct->year, ct->month, ct->day) * 86400U + ct->hours * 3600U + ct->minutes * 60U
+		   + ct->seconds;
+}
+
+/**
+ * @brief This function converts Unix time to a date and time
+ *
+ * @param secs	Seconds since 1970-01-01 00:00:00
+ * @param ct	Converted date and time
+ * */
+void epoch_to_civil(uint32_t secs, civil_time_t* ct){
+	uint32_t days, sod, rem, hours, minutes;
+
+	days = (uint32_t)(((uint64_t)(secs >> 7) * 50903317U) >> 35);	/* secs / 86400 */
+	sod = secs - days * 86400U;
+
+	hours = (sod * 37283U) >> 27;									/* sod / 3600 */
+	rem = sod - hours * 3600U;
+	minutes = (rem * 2185U) >> 17;									/* rem / 60 */
+
+	ct->hours = hours;
+	ct->minutes = minutes;
+	ct->seconds = rem - minutes * 60U;
+
+	epoch_civil_from_days(days, ct);
+}
+
+/**
+ * @brief This function converts a date and time to Unix time in milliseconds
+ * */
+uint64_t epoch_ms_from_civil(const civil_time_t* ct, uint32_t ms){
+
+	return (uint64_t)epoch_from_civil(ct) * 1000U + ms;
+}
+
+/**
+ * @brief This function converts Unix time in milliseconds to a date and time
+ *
+ * @param ms	Milliseconds since 1970-01-01 00:00:00
+ * @param ct	Converted date and time
+ *
+ * @return The milliseconds within the second
+ * */
+uint32_t epoch_ms_to_civil(uint64_t ms, civil_time_t* ct){
+	uint32_t hi = (uint32_t)(ms >> 32);
+	uint64_t rem;
+	uint32_t secs;
+
+	// ms = hi * 2^32 + lo and 2^32 = 4294967 * 1000 + 296
+	rem = (uint64_t)hi * 296U + (uint32_t)ms;						/* < 2^33 up to 2106 */
+	secs = (uint32_t)(((rem >> 3) * 274877907U) >> 35);			/* rem / 1000 */
+
+	epoch_to_civil(hi * 4294967U + secs, ct);
+
+	return (uint32_t)(rem - (uint64_t)secs * 1000U);
+}
+
+/**
+ * @brief This function converts the RTC time and date to a calendar date and time
+ *
+ * @param hour_format	RTC_HOURFORMAT_12 or RTC_HOURFORMAT_24 (hrtc.Init.HourFormat)
+ * */
+void epoch_civil_from_rtc(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format,
+						  civil_time_t* ct){
+	uint32_t hours = sTime->Hours;
+
+	// 12 AM is 00, 12 PM is 12
+	if(hour_format == RTC_HOURFORMAT_12){
+		hours = (hours == 12 ? 0 : hours) + (sTime->TimeFormat == RTC_HOURFORMAT12_PM) * 12;
+	}
+
+	ct->year = EPOCH_RTC_YEAR_BASE + sDate->Year;
+	ct->month = sDate->Month;
+	ct->day = sDate->Date;
+	ct->weekday = sDate->WeekDay;
+	ct->hours = hours;
+	ct->minutes = sTime->Minutes;
+	ct->seconds = sTime->Seconds;
+}
+
+/**
+ * @brief This function converts a calendar date and time to the RTC time and date
+ *
+ * @param hour_format	RTC_HOURFORMAT_12 or RTC_HOURFORMAT_24 (hrtc.Init.HourFormat)
+ *
+ * @note Only the calendar fields are set
+ * */
+void epoch_civil_to_rtc(const civil_time_t* ct, uint32_t hour_format, RTC_TimeTypeDef* sTime,
+						RTC_DateTypeDef* sDate){
+	uint32_t hours = ct->hours;
+	uint32_t pm = (hours >= 12);
+
+	sTime->TimeFormat = RTC_HOURFORMAT12_AM;
+	if(hour_format == RTC_HOURFORMAT_12){
+		hours -= pm * 12;
+		hours += (hours == 0) * 12;
+		sTime->TimeFormat = pm ? RTC_HOURFORMAT12_PM : RTC_HOURFORMAT12_AM;
+	}
+
+	sTime->Hours = hours;
+	sTime->Minutes = ct->minutes;
+	sTime->Seconds = ct->seconds;
+
+	sDate->Year = ct->year - EPOCH_RTC_YEAR_BASE;
+	sDate->Month = ct->month;
+	sDate->Date = ct->day;
+	sDate->WeekDay = ct->weekday;
+}
+
+/**
+ * @brief This function converts the RTC time and date to Unix time
+ * */
+uint32_t epoch_from_rtc(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format){
+	civil_time_t ct;
+
+	epoch_civil_from_rtc(sTime, sDate, hour_format, &ct);
+
+	return epoch_from_civil(&ct);
+}
+
+/**
+ * @brief This function converts Unix time to the RTC time and date
+ * */
+void epoch_to_rtc(uint32_t secs, uint32_t hour_format, RTC_TimeTypeDef* sTime, RTC_DateTypeDef* sDate){
+	civil_time_t ct;
+
+	epoch_to_civil(secs, &ct);
+	epoch_civil_to_rtc(&ct, hour_format, sTime, sDate);
+}
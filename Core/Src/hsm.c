@@ -0,0 +1,244 @@
+/*
+ * hsm.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdint.h>
+#include "hsm.h"
+
+/**
+ * @brief This function counts the nesting levels of a state
+ *
+ * @return The levels (1 for a top state), HSM_DEPTH_MAX + 1 on a loop, too deep nesting or an invalid parent
+ * */
+static uint32_t hsm_depth(const hsm_def_t* def, uint8_t state){
+	uint32_t depth = 0;
+
+	while(state != HSM_NONE){
+		if(state >= def->nstates || depth == HSM_DEPTH_MAX){
+			return HSM_DEPTH_MAX + 1;
+		}
+		depth++;
+		state = def->states[state].parent;
+	}
+
+	return depth;
+}
+
+/**
+ * @brief This function marks a state and its parents as reached
+ *
+ * @return Non zero value if a state was not marked before
+ * */
+static uint32_t hsm_reach(const hsm_def_t* def, uint32_t* reached, uint8_t state){
+	uint32_t marked = 0;
+
+	for(; state != HSM_NONE; state = def->states[state].parent){
+		if((reached[state / 32] & (1UL << (state % 32))) == 0){
+			reached[state / 32] |= 1UL << (state % 32);
+			marked = 1;
+		}
+	}
+
+	return marked;
+}
+
+/**
+ * @brief This function verifies the state machine tables and builds the flat transitions table
+ *
+ * @param me	The state machine
+ * @param def	States and transitions
+ * @param table	HSM_TABLE_SIZE(def->nstates, def->nevents) bytes
+ *
+ * @return HSM_OK, an error on an invalid definition (every state and event pair is checked)
+ *
+ * @note The state machine starts with hsm_start()
+ * */
+hsm_err_t hsm_init(hsm_t* me, const hsm_def_t* def, uint8_t* table){
+	const hsm_transition_t* t;
+	uint32_t reached[8] = {0};		/* 256 states bitmap */
+	uint32_t changed;
+	uint8_t target;
+	uint8_t s, e, p;
+	uint32_t i;
+
+	if(def->nstates == 0 || def->nevents == 0 || def->nstates >= HSM_NONE || def->nevents >= HSM_NONE ||
+			def->initial >= def->nstates){
+		return HSM_ERR_SIZE;
+	}
+
+	for(s = 0; s < def->nstates; s++){
+		if(hsm_depth(def, s) > HSM_DEPTH_MAX){
+			return HSM_ERR_PARENT;
+		}
+	}
+
+	// Declared transitions
+	for(i = 0; i < HSM_TABLE_SIZE(def->nstates, def->nevents); i++){
+		table[i] = HSM_NONE;
+	}
+
+	for(i = 0; i < def->ntransitions; i++){
+		t = &def->transitions[i];
+		if(t->source >= def->nstates || t->event >= def->nevents || t->target >= def->nstates){
+			return HSM_ERR_TRANSITION;
+		}
+		if(table[t->source * def->nevents + t->event] != HSM_NONE){
+			return HSM_ERR_DUPLICATE;
+		}
+		table[t->source * def->nevents + t->event] = t->target;
+	}
+
+	// Inherited transitions - the nearest parent that handles the event
+	for(s = 0; s < def->nstates; s++){
+		for(e = 0; e < def->nevents; e++){
+			target = table[s * def->nevents + e];
+			for(p = def->states[s].parent; target == HSM_NONE && p != HSM_NONE; p = def->states[p].parent){
+				target = table[p * def->nevents + e];
+			}
+			table[s * def->nevents + e] = target;
+		}
+	}
+
+	// Every state is reached from the initial state (as a target or the parent of one)
+	hsm_reach(def, reached, def->initial);
+	do{
+		changed = 0;
+		for(s = 0; s < def->nstates; s++){
+			if((reached[s / 32] & (1UL << (s % 32))) == 0){
+				continue;
+			}
+			for(e = 0; e < def->nevents; e++){
+				target = table[s * def->nevents + e];
+				if(target != HSM_NONE){
+					changed |= hsm_reach(def, reached, target);
+				}
+			}
+		}
+	}
+	while(changed);
+
+	for(s = 0; s < def->nstates; s++){
+		if((reached[s / 32] & (1UL << (s % 32))) == 0){
+			return HSM_ERR_UNREACHABLE;
+		}
+	}
+
+	me->def = def;
+	me->table = table;
+	me->current = def->initial;
+
+	return HSM_OK;
+}
+
+/**
+ * @brief This function enters the initial state - the entry actions run from the top state down
+ * */
+void hsm_start(hsm_t* me){
+	const hsm_state_t* states = me->def->states;
+	uint8_t path[HSM_DEPTH_MAX];
+	uint32_t n = 0;
+	uint8_t s;
+
+	for(s = me->def->initial; s != HSM_NONE; s = states[s].parent){
+		path[n++] = s;
+	}
+
+	me->current = me->def->initial;
+
+	while(n--){
+		if(states[path[n]].entry){
+			states[path[n]].entry();
+		}
+	}
+}
+
+/**
+ * @brief This function takes a transition - exit actions up to the common ancestor, entry actions down to the target
+ * */
+static void hsm_transition(hsm_t* me, uint8_t target){
+	const hsm_state_t* states = me->def->states;
+	uint8_t path[HSM_DEPTH_MAX];
+	uint32_t n = 0;
+	uint32_t i = 0;
+	uint8_t s;
+
+	// The target and its parents
+	for(s = target; s != HSM_NONE; s = states[s].parent){
+		path[n++] = s;
+	}
+
+	// Exit up to the common ancestor - a parent of the target (path[1..n-1])
+	for(s = me->current; s != HSM_NONE; s = states[s].parent){
+		for(i = 1; i < n && path[i] != s; i++);
+		if(i < n){
+			break;
+		}
+		if(states[s].exit){
+			states[s].exit();
+		}
+	}
+
+	if(s == HSM_NONE){
+		i = n;
+	}
+
+	me->current = target;
+
+	// Enter from below the common ancestor
+	while(i--){
+		if(states[path[i]].entry){
+			states[path[i]].entry();
+		}
+	}
+}
+
+/**
+ * @brief This function dispatches an event
+ *
+ * @param me	The state machine
+ * @param event	The event id
+ *
+ * @return Non zero value if a transition was taken, zero if the current state does not handle the event
+ *
+ * @note The actions must not dispatch events
+ * */
+uint32_t hsm_dispatch(hsm_t* me, uint8_t event){
+	uint8_t target;
+
+	if(event >= me->def->nevents){
+		return 0;
+	}
+
+	target = me->table[me->current * me->def->nevents + event];
+	if(target == HSM_NONE){
+		return 0;
+	}
+
+	hsm_transition(me, target);
+
+	return 1;
+}
+
+/**
+ * @brief This function returns the current state
+ * */
+uint8_t hsm_state(const hsm_t* me){
+	return me->current;
+}
+
+/**
+ * @brief This function checks if a state is the current state or one of its parents
+ * */
+uint32_t hsm_in(const hsm_t* me, uint8_t state){
+	uint8_t s;
+
+	for(s = me->current; s != HSM_NONE; s = me->def->states[s].parent){
+		if(s == state){
+			return 1;
+		}
+	}
+
+	return 0;
+}
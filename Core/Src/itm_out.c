@@ -0,0 +1,184 @@
+/*
+ * itm_out.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "itm_out.h"
+
+#if (ITM_OUT_LOG_SIZE & (ITM_OUT_LOG_SIZE - 1))
+#error "The ITM output ring sizes must be a power of 2"
+#endif
+
+#if (ITM_OUT_LOG_SIZE > 0x8000)
+#error "The ITM output ring sizes are limited to 32 KB (16 bits indexes)"
+#endif
+
+/*
+ * Ring state word: writers << 16 | head.
+ * A writer reserves [head, head + len) and increments writers in one STREX, copies the data and then
+ * decrements writers. The last writer out publishes head to commit - the writers nest (an ISR
+ * preempts a task and completes first) so the bytes up to commit are always complete.
+ * The indexes are free running 16 bits counters.
+ */
+#define ITM_IDX_MASK		0xFFFFU
+#define ITM_WRITER			0x10000U
+
+typedef struct{
+	volatile uint32_t state;	/* writers << 16 | head */
+	volatile uint32_t commit;	/* end of the complete data */
+	volatile uint32_t tail;		/* drained up to here - written by the idle task only */
+	uint8_t* buf;
+	uint32_t mask;
+	uint32_t port;
+}itm_ring_t;
+
+static uint8_t itm_log_buf[ITM_OUT_LOG_SIZE];
+
+static itm_ring_t itm_rings[ITM_CH_NUM] = {
+	[ITM_CH_LOG]	= { .buf = itm_log_buf, .mask = ITM_OUT_LOG_SIZE - 1, .port = ITM_OUT_LOG_PORT },
+};
+
+itm_out_stats_t itm_out_stats[ITM_CH_NUM];
+
+/**
+ * @brief This function adds to a counter shared by the writers
+ * */
+static void itm_out_count(uint32_t* counter, uint32_t n){
+	uint32_t value;
+
+	do{
+		value = __LDREXW(counter);
+	}while(__STREXW(value + n, counter));
+}
+
+/**
+ * @brief This function enables the trace and the stimulus ports of the channels
+ *
+ * @note The debugger (SWV configuration) may override the settings
+ * */
+void itm_out_init(void){
+	uint32_t ch;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+	for(ch = 0; ch < ITM_CH_NUM; ch++){
+		ITM->TER |= 1U << itm_rings[ch].port;
+	}
+}
+
+/**
+ * @brief This function writes data to an output channel
+ *
+ * @param ch	Output channel
+ * @param data	Data to write
+ * @param len	Data length
+ *
+ * @return The number of bytes written - len, or 0 if the data does not fit (dropped)
+ *
+ * @note Never blocks, lock-free - can be called from a task or any ISR (also above
+ * 		 configMAX_SYSCALL_INTERRUPT_PRIORITY)
+ * */
+uint32_t itm_out_write(itm_ch_t ch, const void* data, uint32_t len){
+	itm_ring_t* ring = &itm_rings[ch];
+	const uint8_t* src = data;
+	uint32_t state;
+	uint32_t head;
+	uint32_t i;
+
+	if(len == 0){
+		return 0;
+	}
+
+	// Reserve the space
+	do{
+		state = __LDREXW(&ring->state);
+		head = state & ITM_IDX_MASK;
+
+		if(ring->mask + 1 - ((head - ring->tail) & ITM_IDX_MASK) < len){
+			__CLREX();
+			itm_out_count(&itm_out_stats[ch].dropped, len);
+			return 0;
+		}
+	}while(__STREXW(((state + len) & ITM_IDX_MASK) | ((state & ~ITM_IDX_MASK) + ITM_WRITER), &ring->state));
+
+	for(i = 0; i < len; i++){
+		ring->buf[(head + i) & ring->mask] = src[i];
+	}
+
+	// Publish - the last writer out commits all the reserved data
+	__DMB();
+	do{
+		state = __LDREXW(&ring->state);
+		if((state & ~ITM_IDX_MASK) == ITM_WRITER){
+			ring->commit = state & ITM_IDX_MASK;
+		}
+	}while(__STREXW(state - ITM_WRITER, &ring->state));
+
+	itm_out_count(&itm_out_stats[ch].written, len);
+
+	return len;
+}
+
+/**
+ * @brief This function drains a channel ring to its stimulus port
+ * */
+static void itm_out_drain_ring(itm_ring_t* ring, itm_out_stats_t* stats){
+	uint32_t commit = ring->commit;
+	uint32_t tail = ring->tail;
+	uint32_t avail;
+	uint32_t word;
+
+	if(tail == commit){
+		return;
+	}
+
+	// No trace - discard, the data would be stale when the trace is enabled
+	if((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & (1U << ring->port)) == 0){
+		itm_out_count(&stats->dropped, (commit - tail) & ITM_IDX_MASK);
+		tail = commit;
+	}
+
+	while(tail != commit){
+		// FIFO full
+		if(ITM->PORT[ring->port].u32 == 0){
+			break;
+		}
+
+		avail = (commit - tail) & ITM_IDX_MASK;
+		if(avail >= 4){
+			// One 4 bytes packet - little endian, the host sees the bytes in order
+			word = ring->buf[tail & ring->mask];
+			word |= (uint32_t)ring->buf[(tail + 1) & ring->mask] << 8;
+			word |= (uint32_t)ring->buf[(tail + 2) & ring->mask] << 16;
+			word |= (uint32_t)ring->buf[(tail + 3) & ring->mask] << 24;
+			ITM->PORT[ring->port].u32 = word;
+			avail = 4;
+		}
+		else{
+			ITM->PORT[ring->port].u8 = ring->buf[tail & ring->mask];
+			avail = 1;
+		}
+
+		tail = (tail + avail) & ITM_IDX_MASK;
+		stats->drained += avail;
+	}
+
+	// Release the space after the bytes were read
+	__DMB();
+	ring->tail = tail;
+}
+
+/**
+ * @brief This function drains the output channels to the ITM
+ *
+ * @note Called from the idle hook - never waits for the ITM FIFO, returns when it is full
+ * */
+void itm_out_drain(void){
+	uint32_t ch;
+
+	for(ch = 0; ch < ITM_CH_NUM; ch++){
+		itm_out_drain_ring(&itm_rings[ch], &itm_out_stats[ch]);
+	}
+}
@@ -5,11 +5,12 @@
  *      Author: vaknin
  */
 #include "main.h"
-
-static char* leds_error_msg = "error (leds_effect): invalid input command\n";
+#include "cmd_registry.h"
 
 volatile eLeds_exec_t exec_flag;
 
+static uint32_t start_tim_once_flag = 1;
+
 /**
  * @brief This function execute the LEDs functions
  *
@@ -111,46 +112,16 @@ void exec_leds_e4(){
 /**
  * @brief This function init the LEDs function execution
  *
- * @param option the option of the function to execute
+ * @param effect the LEDs function to execute (eLeds_exec_t)
  *
  * @retval uiny32_t Non zero value when exit back to Main Menu
  *
  * */
-uint32_t leds_execute(char* option){
-	BaseType_t status;
-	static uint32_t start_tim_once_flag = 1;
+uint32_t leds_execute(uint32_t effect, const arg_val_t* args){
 
 	leds_turn_off();
 
-	if(!strcmp(option, "e1")){
-		exec_flag = exec_e1;
-	}
-	else if(!strcmp(option, "e2")){
-		exec_flag = exec_e2;
-	}
-	else if(!strcmp(option, "e3")){
-		exec_flag = exec_e3;
-	}
-	else if(!strcmp(option, "e4")){
-		exec_flag = exec_e4;
-	}
-	else if(!strcmp(option, "exit")){
-		// LEDs effect stop
-		HAL_TIM_Base_Stop(&htim7);
-		exec_flag = exec_none;
-		leds_turn_off();
-
-		// Back to main
-		app_curr_state = sMainMenu;
-		status = xTaskNotify(menu_task_handle, 0, eNoAction);
-		configASSERT(status == pdPASS);
-		start_tim_once_flag = 1;
-		return 1;
-	}
-	else{
-		// Invalid input
-		xQueueSend(q_print, &leds_error_msg, 0);
-	}
+	exec_flag = (eLeds_exec_t)effect;
 
 	// Start timer
 	if(start_tim_once_flag){
@@ -161,4 +132,41 @@ uint32_t leds_execute(char* option){
 	return 0;
 }
 
+/**
+ * @brief This function stops the LEDs function
+ *
+ * @note The exit action of the LEDs menu (sLedEffect)
+ * */
+void leds_stop(void){
+
+	// LEDs effect stop
+	HAL_TIM_Base_Stop(&htim7);
+	exec_flag = exec_none;
+	leds_turn_off();
+
+	start_tim_once_flag = 1;
+}
+
+/**
+ * @brief This function exits back to Main Menu - the effect is stopped by the state exit (leds_stop())
+ *
+ * @retval uiny32_t Non zero value - exit back to Main Menu
+ *
+ * */
+uint32_t leds_exit(uint32_t param, const arg_val_t* args){
+
+	// Back to main
+	app_event(evBack);
+
+	return 1;
+}
 
+/* LEDs menu commands */
+const cmd_entry_t leds_cmds[] = {
+	{CMD_GROUP_LEDS, "e1",   0, NULL, leds_execute, exec_e1},
+	{CMD_GROUP_LEDS, "e2",   0, NULL, leds_execute, exec_e2},
+	{CMD_GROUP_LEDS, "e3",   0, NULL, leds_execute, exec_e3},
+	{CMD_GROUP_LEDS, "e4",   0, NULL, leds_execute, exec_e4},
+	{CMD_GROUP_LEDS, "exit", 0, NULL, leds_exit,    0},
+	{0}
+};
@@ -0,0 +1,366 @@
+/*
+ * lp_idle.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "uart_rx.h"
+#include "rtc_cache.h"
+#include "rtc_report.h"
+#include "clk_profile.h"
+#include "lp_idle.h"
+
+#if (configUSE_TICKLESS_IDLE != 1)
+#error "lp_idle.c requires configUSE_TICKLESS_IDLE"
+#endif
+
+#define LP_IDLE_WUT_DIV			16		/* RTC_WAKEUPCLOCK_RTCCLK_DIV16 */
+#define LP_IDLE_DAY_SECONDS		86400U
+
+/* The port SysTick implementation - used for the WFI sleeps */
+extern void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+lp_idle_stats_t lp_idle_stats;
+
+/**
+ * @brief This function reads the RTC time of day
+ *
+ * @return The time of day in sub second units (1 / (PREDIV_S + 1) seconds)
+ *
+ * @note Reading SSR locks TR and DR in the shadow registers until DR is read
+ * */
+static uint32_t lp_idle_rtc_units(uint32_t prediv_s){
+	uint32_t ssr, tr, hours, seconds;
+
+	ssr = hrtc.Instance->SSR & RTC_SSR_SS;
+	tr = hrtc.Instance->TR & RTC_TR_RESERVED_MASK;
+	(void)hrtc.Instance->DR;
+
+	hours = RTC_Bcd2ToByte((tr & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos);
+	if(hrtc.Init.HourFormat == RTC_HOURFORMAT_12){
+		hours %= 12;
+		if(tr & RTC_TR_PM){
+			hours += 12;
+		}
+	}
+
+	seconds = hours * 3600
+			+ RTC_Bcd2ToByte((tr & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos) * 60
+			+ RTC_Bcd2ToByte(tr & (RTC_TR_ST | RTC_TR_SU));
+
+	if(ssr > prediv_s){
+		ssr = prediv_s;
+	}
+
+	return seconds * (prediv_s + 1) + (prediv_s - ssr);
+}
+
+/**
+ * @brief This function checks whether STOP mode would break a running activity
+ *
+ * @return The reason STOP is held off, NULL if STOP is allowed
+ * */
+static const char* lp_idle_stop_hold(void){
+
+	// The report subscriptions own the RTC wakeup timer
+	if(rtc_report_stats.subs){
+		return "report";
+	}
+
+	// A LED effect is running
+	if(htim7.Instance->CR1 & TIM_CR1_CEN){
+		return "leds";
+	}
+
+	// A transmission is in progress (DMA or the last frame in the shift register)
+	if(huart2.gState != HAL_UART_STATE_READY || (huart2.Instance->SR & USART_SR_TC) == 0){
+		return "uart";
+	}
+
+	// The first character after STOP is lost - wait for the console to go quiet
+	if(xTaskGetTickCount() - uart_rx_last_tick < pdMS_TO_TICKS(LP_IDLE_CONSOLE_MS)){
+		return "console";
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief This function sleeps in STOP mode until the RTC wakeup timer or console input
+ *
+ * @param expected The idle time (ticks), at least LP_IDLE_STOP_MIN_MS
+ *
+ * @note Called by the idle task with the scheduler suspended
+ * */
+static void lp_idle_stop(TickType_t expected){
+	uint32_t prediv_s, rtcclk, counts;
+	uint32_t start, units, elapsed;
+	uint32_t cycles, lat_us;
+	TickType_t ticks;
+
+	// Wake up one tick early, the tick interrupt handles the rest
+	elapsed = (expected - 1) * portTICK_PERIOD_MS;
+	if(elapsed > LP_IDLE_STOP_MAX_MS){
+		elapsed = LP_IDLE_STOP_MAX_MS;
+	}
+
+	// RTCCLK as the calendar sees it - the wakeup timer and the calendar agree even though the LSI is not exact
+	prediv_s = hrtc.Instance->PRER & RTC_PRER_PREDIV_S;
+	rtcclk = (((hrtc.Instance->PRER & RTC_PRER_PREDIV_A) >> RTC_PRER_PREDIV_A_Pos) + 1) * (prediv_s + 1);
+	counts = elapsed * (rtcclk / LP_IDLE_WUT_DIV) / 1000;
+	if(counts > RTC_WUTR_WUT){
+		counts = RTC_WUTR_WUT;
+	}
+
+	// The kernel interrupts are masked, the HAL time base (TIM6, priority 0) bounds the HAL timeouts
+	__set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+	__DSB();
+	__ISB();
+
+	// A task became ready or a context switch is pending
+	if(eTaskConfirmSleepModeStatus() == eAbortSleep){
+		__set_BASEPRI(0);
+		return;
+	}
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+	if(HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, counts - 1, RTC_WAKEUPCLOCK_RTCCLK_DIV16) != HAL_OK){
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		__set_BASEPRI(0);
+		return;
+	}
+
+	// The HAL time base (TIM6) would end STOP at once - an update already pending runs after the resume
+	HAL_SuspendTick();
+
+	// WFI wakes on the interrupts masked by PRIMASK only - the wake sources stay pending until released
+	__disable_irq();
+	__set_BASEPRI(0);
+	NVIC_ClearPendingIRQ(TIM6_DAC_IRQn);
+
+	// Console input - the start bit on the RX pin (EXTI3, routed to PA3 by lp_idle_init())
+	EXTI->PR = EXTI_PR_PR3;
+	EXTI->FTSR |= EXTI_FTSR_TR3;
+	EXTI->IMR |= EXTI_IMR_MR3;
+	NVIC_ClearPendingIRQ(EXTI3_IRQn);
+	NVIC_EnableIRQ(EXTI3_IRQn);
+
+	start = lp_idle_rtc_units(prediv_s);
+
+	HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+	// Back to the kernel interrupts masked (EXTI3 has no handler) - the HSE, PLL and RTC waits below
+	// time out on the HAL tick, resumed first
+	NVIC_DisableIRQ(EXTI3_IRQn);
+	__set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+	__enable_irq();
+	__ISB();
+	HAL_ResumeTick();
+
+	// Running on the HSI - restore the clock profile (the DWT counts HSI cycles until the switch)
+	cycles = DWT->CYCCNT;
+	clk_profile_restore();
+	cycles = DWT->CYCCNT - cycles;
+	lat_us = cycles / (HSI_VALUE / 1000000U);
+
+	// The calendar shadow registers are stale after STOP
+	__HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
+	HAL_RTC_WaitForSynchro(&hrtc);
+	__HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
+
+	// The wakeup timer period is exact, an early wakeup is measured on the calendar (1 / (PREDIV_S + 1) resolution)
+	if(__HAL_RTC_WAKEUPTIMER_GET_FLAG(&hrtc, RTC_FLAG_WUTF) == 0U){
+		units = lp_idle_rtc_units(prediv_s) + LP_IDLE_DAY_SECONDS * (prediv_s + 1) - start;
+		units %= LP_IDLE_DAY_SECONDS * (prediv_s + 1);
+		elapsed = units * 1000 / (prediv_s + 1);
+	}
+	else{
+		elapsed = counts * LP_IDLE_WUT_DIV * 1000 / rtcclk;
+	}
+
+	if(EXTI->PR & EXTI_PR_PR3){
+		lp_idle_stats.uart_wakes++;
+	}
+
+	// Release the wake sources - their interrupts are cleared before they run
+	HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+	__HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(&hrtc, RTC_FLAG_WUTF);
+	__HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG();
+	NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+	EXTI->IMR &= ~EXTI_IMR_MR3;
+	EXTI->FTSR &= ~EXTI_FTSR_TR3;
+	EXTI->PR = EXTI_PR_PR3;
+	NVIC_DisableIRQ(EXTI3_IRQn);
+	NVIC_ClearPendingIRQ(EXTI3_IRQn);
+
+	// Step the kernel and the HAL ticks (the HAL time base stopped with the clocks)
+	ticks = elapsed / portTICK_PERIOD_MS;
+	if(ticks > expected - 1){
+		ticks = expected - 1;
+	}
+	vTaskStepTick(ticks);
+	uwTick += ticks * portTICK_PERIOD_MS;
+
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	lp_idle_stats.stop_entries++;
+	lp_idle_stats.stop_ms += elapsed;
+	lp_idle_stats.lat_last_us = lat_us;
+	lp_idle_stats.lat_sum_us += lat_us;
+	if(lat_us > lp_idle_stats.lat_max_us){
+		lp_idle_stats.lat_max_us = lat_us;
+	}
+
+	__set_BASEPRI(0);
+
+	rtc_cache_invalidate();
+}
+
+/**
+ * @brief This function prepares the STOP mode wake sources
+ *
+ * @note Call before the scheduler starts
+ * */
+void lp_idle_init(void){
+
+	// EXTI3 from PA3 (USART2 RX) - enabled only while in STOP
+	SYSCFG->EXTICR[0] = (SYSCFG->EXTICR[0] & ~SYSCFG_EXTICR1_EXTI3) | SYSCFG_EXTICR1_EXTI3_PA;
+
+	// Keep the debugger connection through SLEEP and STOP
+	if(CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk){
+		DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP | DBGMCU_CR_DBG_STOP;
+	}
+}
+
+/**
+ * @brief This function is the tickless idle implementation (portSUPPRESS_TICKS_AND_SLEEP)
+ *
+ * @param expected The number of ticks until a task unblocks
+ *
+ * @note Called by the idle task with the scheduler suspended
+ * */
+void lp_idle_sleep(TickType_t expected){
+	TickType_t start;
+	uint32_t slept;
+
+	if(expected >= pdMS_TO_TICKS(LP_IDLE_STOP_MIN_MS)){
+		lp_idle_stats.hold = lp_idle_stop_hold();
+		if(lp_idle_stats.hold == NULL){
+			lp_idle_stop(expected);
+			return;
+		}
+	}
+
+	// The HAL time base (TIM6) would end the sleep every millisecond
+	start = xTaskGetTickCount();
+	HAL_SuspendTick();
+
+	vPortSuppressTicksAndSleep(expected);
+
+	slept = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+	uwTick += slept;
+	HAL_ResumeTick();
+
+	lp_idle_stats.wfi_sleeps++;
+	lp_idle_stats.wfi_ms += slept;
+}
+
+/**
+ * @brief This function formats a residency line - "name entries ms percent"
+ * */
+static char* lp_idle_fmt_mode(char* p, const char* end, const char* name, uint32_t entries, uint32_t ms, uint32_t uptime){
+	uint32_t hundredths = uptime ? (uint32_t)((uint64_t)ms * 10000 / uptime) : 0;
+
+	p = time_fmt_str(p, end, name);
+	p = time_fmt_u32_align(p, end, entries, 10);
+	p = time_fmt_u32_align(p, end, ms, 11);
+	p = time_fmt_u32_align(p, end, hundredths / 100, 8);
+	p = time_fmt_chr(p, end, '.');
+	p = time_fmt_u2(p, end, hundredths % 100);
+	p = time_fmt_str(p, end, "%\n");
+
+	return p;
+}
+
+/**
+ * @brief This function prints the sleep residency and the STOP wake latency to the console
+ *
+ * @param timeout Queue send timeout
+ * */
+void lp_idle_report(TickType_t timeout){
+	lp_idle_stats_t stats;
+	uint32_t uptime;
+	char* msg;
+	char* p;
+	char* end;
+
+	taskENTER_CRITICAL();
+	stats = lp_idle_stats;
+	uptime = xTaskGetTickCount() * portTICK_PERIOD_MS;
+	taskEXIT_CRITICAL();
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = time_fmt_str(msg, end, "Uptime ");
+	p = time_fmt_u32(p, end, uptime);
+	p = time_fmt_str(p, end, " ms\nMode   Entries         ms   Residency\n");
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = lp_idle_fmt_mode(msg, end, "WFI ", stats.wfi_sleeps, stats.wfi_ms, uptime);
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = lp_idle_fmt_mode(msg, end, "STOP", stats.stop_entries, stats.stop_ms, uptime);
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	// Truncated at the block end, room for the new line
+	end = msg + MSG_POOL_BLOCK_SIZE - 1;
+	p = time_fmt_str(msg, end, "Wake latency us: last ");
+	p = time_fmt_u32(p, end, stats.lat_last_us);
+	p = time_fmt_str(p, end, " avg ");
+	p = time_fmt_u32(p, end, stats.stop_entries ? (uint32_t)(stats.lat_sum_us / stats.stop_entries) : 0);
+	p = time_fmt_str(p, end, " max ");
+	p = time_fmt_u32(p, end, stats.lat_max_us);
+	*p++ = '\n';
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	// Truncated at the block end, room for the new line
+	end = msg + MSG_POOL_BLOCK_SIZE - 1;
+	p = time_fmt_str(msg, end, "Console wakes ");
+	p = time_fmt_u32(p, end, stats.uart_wakes);
+	p = time_fmt_str(p, end, ", STOP held by: ");
+	p = time_fmt_str(p, end, stats.hold ? stats.hold : "-");
+	*p++ = '\n';
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+}
@@ -21,19 +21,46 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "uart_rx.h"
+#include "msg_pool.h"
+#include "cmd_registry.h"
+#include "rtc_report.h"
+#include "dlog.h"
+#include "itm_out.h"
+#include "cpu_stats.h"
+#include "stack_mon.h"
+#include "mem_heap.h"
+#include "lp_idle.h"
+#include "clk_profile.h"
 
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+/* Application task - created static */
+typedef struct{
+	TaskFunction_t entry;
+	const char* name;
+	uint32_t depth;			/* stack depth (words) */
+	UBaseType_t priority;
+	StackType_t* stack;
+	StaticTask_t* tcb;
+	TaskHandle_t* handle;
+}app_task_t;
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 
-uint8_t user_data;			// global Rx data
-uint8_t uart_tx_buff[512] = {0};
+/* Task stack depths (words) - see the "stack" command for the measured usage */
+#define AO_STACK_DEPTH			256
+#define PRINT_STACK_DEPTH		256
+#define CMD_STACK_DEPTH			256
+#define RTC_REPORT_STACK_DEPTH	256
+
+#define PRINT_QUEUE_LEN			10
 
 /* USER CODE END PD */
 
@@ -48,23 +75,21 @@ RTC_HandleTypeDef hrtc;
 TIM_HandleTypeDef htim7;
 
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 /* USER CODE BEGIN PV */
-TimerHandle_t rtc_timer;
-
-TaskHandle_t menu_task_handle;
-TaskHandle_t leds_task_handle;
-TaskHandle_t rtc_task_handle;
+TaskHandle_t ao_task_handle;
 TaskHandle_t print_task_handle;
 TaskHandle_t cmd_handler_task_handle;
-
-state_t app_curr_state = sMainMenu;
+TaskHandle_t rtc_report_task_handle;
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_RTC_Init(void);
 static void MX_TIM7_Init(void);
 static void MX_USART2_UART_Init(void);
@@ -77,19 +102,14 @@ void UART_GPIOs_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-QueueHandle_t q_data;
 QueueHandle_t q_print;
 
-void menu_task(void* params){
-	menu_task_handler(params);
-}
-
-void leds_task(void* params){
-	leds_task_handler(params);
-}
+/* Print queue - SRAM */
+static StaticQueue_t q_print_struct;
+static uint8_t q_print_storage[PRINT_QUEUE_LEN * sizeof(tx_command_t)];
 
-void rtc_task(void* params){
-	rtc_task_handler(params);
+void ao_task(void* params){
+	ao_task_handler(params);
 }
 
 void print_task(void* params){
@@ -100,6 +120,81 @@ void cmd_handler_task(void* params){
 	command_handle_task_handler(params);
 }
 
+void rtc_report_task(void* params){
+	rtc_report_task_handler(params);
+}
+
+/* Task stacks and control blocks - CCMRAM (CPU only) */
+static StackType_t ao_stack[AO_STACK_DEPTH] CCMRAM_NOINIT;
+static StackType_t print_stack[PRINT_STACK_DEPTH] CCMRAM_NOINIT;
+static StackType_t cmd_stack[CMD_STACK_DEPTH] CCMRAM_NOINIT;
+static StackType_t rtc_report_stack[RTC_REPORT_STACK_DEPTH] CCMRAM_NOINIT;
+static StackType_t idle_stack[configMINIMAL_STACK_SIZE] CCMRAM_NOINIT;
+static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH] CCMRAM_NOINIT;
+
+static StaticTask_t app_tcbs[4] CCMRAM_NOINIT;
+static StaticTask_t idle_tcb CCMRAM_NOINIT;
+static StaticTask_t timer_tcb CCMRAM_NOINIT;
+
+static const app_task_t app_tasks[] = {
+	// Active objects dispatcher - the Main Menu, LEDs and RTC menus (tasks_handler.c)
+	{ao_task, "AO", AO_STACK_DEPTH, 2, ao_stack, &app_tcbs[0], &ao_task_handle},
+	{print_task, "Print_UART", PRINT_STACK_DEPTH, 2, print_stack, &app_tcbs[1], &print_task_handle},
+	{cmd_handler_task, "CMD", CMD_STACK_DEPTH, 2, cmd_stack, &app_tcbs[2], &cmd_handler_task_handle},
+	// RTC reporting - woken by the RTC wakeup timer, lower priority than the console
+	{rtc_report_task, "RTC_Report", RTC_REPORT_STACK_DEPTH, 1, rtc_report_stack, &app_tcbs[3], &rtc_report_task_handle},
+};
+
+/**
+ * @brief This function creates the application tasks
+ *
+ * @note Static - no heap, the same layout on every boot
+ * */
+static void app_tasks_create(void){
+	const app_task_t* task;
+	uint32_t i;
+
+	for(i = 0; i < sizeof(app_tasks) / sizeof(app_tasks[0]); i++){
+		task = &app_tasks[i];
+		*task->handle = xTaskCreateStatic(task->entry, task->name, task->depth, NULL, task->priority, task->stack, task->tcb);
+		configASSERT(*task->handle);
+	}
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer,
+								   uint32_t* pulIdleTaskStackSize){
+	*ppxIdleTaskTCBBuffer = &idle_tcb;
+	*ppxIdleTaskStackBuffer = idle_stack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer,
+									uint32_t* pulTimerTaskStackSize){
+	*ppxTimerTaskTCBBuffer = &timer_tcb;
+	*ppxTimerTaskStackBuffer = timer_stack;
+	*pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+void vApplicationIdleHook(void){
+	// Background output of the deferred log and the buffered ITM channels
+	dlog_drain();
+	itm_out_drain();
+
+	// Stack high-water marks - sampled while awake, before the tickless sleep
+	stack_mon_idle();
+}
+
+void vApplicationTickHook(void){
+	// Catch the cycle counter wraps of the run time stats
+	cpu_stats_cycles();
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName){
+	// Keep the evidence for the next boot (stack report) and halt
+	stack_mon_overflow(pcTaskName);
+	configASSERT(0);
+}
+
 
 /* USER CODE END 0 */
 
@@ -111,7 +206,6 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-	BaseType_t status = pdPASS;
 
   /* USER CODE END 1 */
 
@@ -134,40 +228,46 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_RTC_Init();
   MX_TIM7_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
 
-  printf("Task 008 started!\n");
+  // Replace the boot clock - the UART and TIM7 are re-derived
+  clk_profile_init();
 
-  // timer create for RTC reporting
-  rtc_timer = xTimerCreate("RTC_Timer", pdMS_TO_TICKS(1000), pdTRUE, 0, rtc_timer_callback);
+  // Heap regions - before any allocation
+  mem_heap_init();
 
-  status = xTaskCreate(menu_task, "Menu", 256, NULL, 2, &menu_task_handle);
-  configASSERT(status == pdPASS);
+  // Buffered ITM output (printf)
+  itm_out_init();
 
-  status = xTaskCreate(leds_task, "LEDS", 256, NULL, 2, &leds_task_handle);
-  configASSERT(status == pdPASS);
+  DLOG("boot: HCLK %lu Hz\n", HAL_RCC_GetHCLKFreq());
 
-  status = xTaskCreate(rtc_task, "RTC", 256, NULL, 2, &rtc_task_handle);
-  configASSERT(status == pdPASS);
+  // Formatted output buffers
+  msg_pool_init();
 
-  status = xTaskCreate(print_task, "Print_UART", 256, NULL, 2, &print_task_handle);
-  configASSERT(status == pdPASS);
+  app_tasks_create();
 
-  status = xTaskCreate(cmd_handler_task, "CMD", 256, NULL, 2, &cmd_handler_task_handle);
-  configASSERT(status == pdPASS);
+  q_print = xQueueCreateStatic(PRINT_QUEUE_LEN, sizeof(tx_command_t), q_print_storage, &q_print_struct);
+  configASSERT(q_print);
 
-  q_data = xQueueCreate(10, sizeof(char));
-  configASSERT(q_data);
+  cmd_pool_init();
+  app_ao_init();
+  cmd_registry_init();
 
-  //q_print = xQueueCreate(10, sizeof(tx_command_t*));
-  q_print = xQueueCreate(10, sizeof(size_t));
-  configASSERT(q_print);
+  // Stack high-water mark table (sampled by the idle hook)
+  stack_mon_init();
+
+  // CPU usage statistics (sampled by the reports)
+  cpu_stats_init();
 
-  // Enable the RX in interrupt mode
-  HAL_UART_Receive_IT(&huart2, &user_data, 1);
+  // STOP mode wake sources for the tickless idle
+  lp_idle_init();
+
+  // Enable the RX in circular DMA mode with idle line detection
+  uart_rx_start(&huart2);
 
   vTaskStartScheduler();
 
@@ -263,8 +363,21 @@ static void MX_RTC_Init(void)
   {
     Error_Handler();
   }
+
+  /** Enable the WakeUp
+  */
+  if (HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, 0, RTC_WAKEUPCLOCK_RTCCLK_DIV16) != HAL_OK)
+  {
+    Error_Handler();
+  }
   /* USER CODE BEGIN RTC_Init 2 */
 
+  // The wakeup timer is programmed by its users (rtc_report.c, lp_idle.c) - stopped until then
+  HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+  __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(&hrtc, RTC_FLAG_WUTF);
+  __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG();
+  HAL_NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
   /* USER CODE END RTC_Init 2 */
 
 }
@@ -341,6 +454,25 @@ static void MX_USART2_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Stream5_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 6, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+  /* DMA1_Stream6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 6, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -540,29 +672,6 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
 }
 #endif
 
-/**
-  * @brief  Rx Transfer completed callbacks.
-  * This function push the received data to the queue.
-  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
-  *                the configuration information for the specified UART module.
-  * @retval None
-  */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
-
-	if(huart->Instance == USART2){
-		// Push data to queue
-		xQueueSendFromISR(q_data, (void*)&user_data, NULL);
-
-		// Check if end of message of the queue is full
-		if(user_data == '\n' || xQueueIsQueueFullFromISR(q_data)){
-			xTaskNotifyFromISR(cmd_handler_task_handle, 0 , eNoAction, NULL);
-		}
-
-		// Re-Enable IT mode
-		HAL_UART_Receive_IT(&huart2, (uint8_t*)&user_data, 1);
-	}
-}
-
 /* USER CODE END 4 */
 
 /**
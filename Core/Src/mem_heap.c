@@ -0,0 +1,357 @@
+/*
+ * mem_heap.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "mem_heap.h"
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+#error "mem_heap.c requires configSUPPORT_DYNAMIC_ALLOCATION"
+#endif
+
+#define MEM_ALIGN			portBYTE_ALIGNMENT
+#define MEM_ALIGN_MASK		(MEM_ALIGN - 1)
+#define MEM_ALLOCATED		((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+/* Block header - in the free list when next is not NULL */
+typedef struct mem_block{
+	struct mem_block* next;
+	size_t size;			/* including the header, MEM_ALLOCATED when in use */
+}mem_block_t;
+
+#define MEM_HDR_SIZE		((sizeof(mem_block_t) + MEM_ALIGN_MASK) & ~MEM_ALIGN_MASK)
+#define MEM_MIN_BLOCK		(MEM_HDR_SIZE * 2)
+
+/* Region heap */
+typedef struct{
+	mem_block_t start;		/* free list head */
+	mem_block_t* end;		/* free list end marker, at the end of the region */
+	uint8_t* base;
+	size_t size;
+	size_t free;
+	size_t min_free;
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t fails;
+}mem_heap_t;
+
+static uint8_t mem_ccm_storage[MEM_HEAP_CCM_SIZE] CCMRAM_NOINIT __attribute__((aligned(MEM_ALIGN)));
+static uint8_t mem_sram_storage[MEM_HEAP_SRAM_SIZE] __attribute__((aligned(MEM_ALIGN)));
+
+static mem_heap_t mem_heaps[MEM_REGION_NUM];
+
+static const char* const mem_region_names[MEM_REGION_NUM] = {"CCM", "SRAM"};
+
+/**
+ * @brief This function builds a region heap - one free block
+ * */
+static void mem_heap_region_init(mem_heap_t* heap, uint8_t* storage, size_t size){
+	mem_block_t* first;
+
+	heap->base = storage;
+	heap->end = (mem_block_t*)((storage + size - MEM_HDR_SIZE) - ((uintptr_t)(storage + size - MEM_HDR_SIZE) & MEM_ALIGN_MASK));
+	heap->end->next = NULL;
+	heap->end->size = 0;
+
+	first = (mem_block_t*)storage;
+	first->size = (uint8_t*)heap->end - storage;
+	first->next = heap->end;
+
+	heap->start.next = first;
+	heap->start.size = 0;
+
+	heap->size = first->size;
+	heap->free = first->size;
+	heap->min_free = first->size;
+	heap->allocs = 0;
+	heap->frees = 0;
+	heap->fails = 0;
+}
+
+/**
+ * @brief This function inserts a free block to the address ordered list, merges the adjacent blocks
+ * */
+static void mem_heap_insert(mem_heap_t* heap, mem_block_t* block){
+	mem_block_t* it = &heap->start;
+
+	while(it->next < block){
+		it = it->next;
+	}
+
+	// Merge with the previous block
+	if(it != &heap->start && (uint8_t*)it + it->size == (uint8_t*)block){
+		it->size += block->size;
+		block = it;
+	}
+
+	// Merge with the next block
+	if(it->next != heap->end && (uint8_t*)block + block->size == (uint8_t*)it->next){
+		block->size += it->next->size;
+		block->next = it->next->next;
+	}
+	else{
+		block->next = it->next;
+	}
+
+	if(block != it){
+		it->next = block;
+	}
+}
+
+/**
+ * @brief This function allocates from a region heap (first fit)
+ *
+ * @note Call with the scheduler suspended
+ * */
+static void* mem_heap_alloc(mem_heap_t* heap, size_t size){
+	mem_block_t* prev = &heap->start;
+	mem_block_t* block;
+	mem_block_t* rest;
+
+	if(size == 0 || size > heap->size){
+		return NULL;
+	}
+
+	size = (size + MEM_HDR_SIZE + MEM_ALIGN_MASK) & ~MEM_ALIGN_MASK;
+	if(size > heap->free){
+		return NULL;
+	}
+
+	block = heap->start.next;
+	while(block->size < size && block->next){
+		prev = block;
+		block = block->next;
+	}
+
+	if(block == heap->end){
+		return NULL;
+	}
+
+	prev->next = block->next;
+
+	// Split - the rest goes back to the free list
+	if(block->size - size > MEM_MIN_BLOCK){
+		rest = (mem_block_t*)((uint8_t*)block + size);
+		rest->size = block->size - size;
+		block->size = size;
+		mem_heap_insert(heap, rest);
+	}
+
+	heap->free -= block->size;
+	if(heap->free < heap->min_free){
+		heap->min_free = heap->free;
+	}
+	heap->allocs++;
+
+	block->size |= MEM_ALLOCATED;
+	block->next = NULL;
+
+	return (uint8_t*)block + MEM_HDR_SIZE;
+}
+
+/**
+ * @brief This function builds the region heaps
+ *
+ * @note Call before any allocation (before the first kernel object is created)
+ * */
+void mem_heap_init(void){
+	mem_heap_region_init(&mem_heaps[MEM_REGION_CCM], mem_ccm_storage, sizeof(mem_ccm_storage));
+	mem_heap_region_init(&mem_heaps[MEM_REGION_SRAM], mem_sram_storage, sizeof(mem_sram_storage));
+}
+
+/**
+ * @brief This function allocates memory from a region
+ *
+ * @param region	MEM_REGION_SRAM for DMA buffers, MEM_REGION_CCM for CPU only data
+ * @param size		Bytes
+ *
+ * @return The block (portBYTE_ALIGNMENT aligned), NULL if there is no free block large enough
+ *
+ * @note Task context only
+ * */
+void* mem_alloc(mem_region_t region, size_t size){
+	void* ptr;
+
+	configASSERT(region < MEM_REGION_NUM);
+
+	vTaskSuspendAll();
+
+	ptr = mem_heap_alloc(&mem_heaps[region], size);
+	if(ptr == NULL){
+		mem_heaps[region].fails++;
+	}
+	traceMALLOC(ptr, size);
+
+	(void)xTaskResumeAll();
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+	if(ptr == NULL){
+		extern void vApplicationMallocFailedHook(void);
+		vApplicationMallocFailedHook();
+	}
+#endif
+
+	return ptr;
+}
+
+/**
+ * @brief This function frees a block of any region
+ *
+ * @param ptr Block returned by mem_alloc() or pvPortMalloc(), NULL is ignored
+ * */
+void mem_free(void* ptr){
+	mem_block_t* block;
+	mem_heap_t* heap;
+	uint32_t r;
+
+	if(ptr == NULL){
+		return;
+	}
+
+	for(r = 0; r < MEM_REGION_NUM; r++){
+		heap = &mem_heaps[r];
+		if((uint8_t*)ptr >= heap->base && (uint8_t*)ptr < (uint8_t*)heap->end){
+			break;
+		}
+	}
+	configASSERT(r < MEM_REGION_NUM);
+
+	block = (mem_block_t*)((uint8_t*)ptr - MEM_HDR_SIZE);
+	configASSERT((block->size & MEM_ALLOCATED) && block->next == NULL);
+
+	vTaskSuspendAll();
+
+	block->size &= ~MEM_ALLOCATED;
+	heap->free += block->size;
+	heap->frees++;
+	traceFREE(ptr, block->size);
+	mem_heap_insert(heap, block);
+
+	(void)xTaskResumeAll();
+}
+
+/**
+ * @brief This function reads the statistics of a region
+ * */
+void mem_heap_get_stats(mem_region_t region, mem_heap_stats_t* stats){
+	mem_heap_t* heap = &mem_heaps[region];
+	mem_block_t* block;
+
+	configASSERT(region < MEM_REGION_NUM);
+
+	stats->largest = 0;
+	stats->blocks = 0;
+
+	vTaskSuspendAll();
+
+	for(block = heap->start.next; block != heap->end; block = block->next){
+		if(block->size > stats->largest){
+			stats->largest = block->size;
+		}
+		stats->blocks++;
+	}
+
+	stats->size = heap->size;
+	stats->free = heap->free;
+	stats->min_free = heap->min_free;
+	stats->allocs = heap->allocs;
+	stats->frees = heap->frees;
+	stats->fails = heap->fails;
+
+	(void)xTaskResumeAll();
+
+	// Usable part of the largest block
+	if(stats->largest > MEM_HDR_SIZE){
+		stats->largest -= MEM_HDR_SIZE;
+	}
+}
+
+/**
+ * @brief This function prints the heap statistics to the console
+ *
+ * @param timeout Queue send timeout
+ * */
+void mem_heap_report(TickType_t timeout){
+	mem_heap_stats_t stats;
+	uint32_t r;
+	char* msg;
+	char* p;
+	char* end;
+
+	queue_send_msg("Heap   Size   Free    Min Largest Blocks Allocs\n", timeout);
+
+	for(r = 0; r < MEM_REGION_NUM; r++){
+		mem_heap_get_stats((mem_region_t)r, &stats);
+
+		msg = msg_pool_alloc();
+		if(msg == NULL){
+			return;
+		}
+
+		// Truncated at the block end, room for the new line
+		end = msg + MSG_POOL_BLOCK_SIZE - 1;
+		p = time_fmt_str(msg, end, mem_region_names[r]);
+		while(p < msg + 4){
+			*p++ = ' ';
+		}
+		p = time_fmt_u32_align(p, end, stats.size, 7);
+		p = time_fmt_u32_align(p, end, stats.free, 7);
+		p = time_fmt_u32_align(p, end, stats.min_free, 7);
+		p = time_fmt_u32_align(p, end, stats.largest, 8);
+		p = time_fmt_u32_align(p, end, stats.blocks, 7);
+		p = time_fmt_u32_align(p, end, stats.allocs, 7);
+		*p++ = '\n';
+
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+	}
+}
+
+/*
+ * FreeRTOS heap interface (portable.h) - the kernel objects are CPU only, CCMRAM first
+ */
+
+void* pvPortMalloc(size_t xWantedSize){
+	void* ptr;
+
+	vTaskSuspendAll();
+
+	ptr = mem_heap_alloc(&mem_heaps[MEM_REGION_CCM], xWantedSize);
+	if(ptr == NULL){
+		ptr = mem_heap_alloc(&mem_heaps[MEM_REGION_SRAM], xWantedSize);
+		if(ptr == NULL){
+			mem_heaps[MEM_REGION_SRAM].fails++;
+		}
+	}
+	traceMALLOC(ptr, xWantedSize);
+
+	(void)xTaskResumeAll();
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+	if(ptr == NULL){
+		extern void vApplicationMallocFailedHook(void);
+		vApplicationMallocFailedHook();
+	}
+#endif
+
+	return ptr;
+}
+
+void vPortFree(void* pv){
+	mem_free(pv);
+}
+
+size_t xPortGetFreeHeapSize(void){
+	return mem_heaps[MEM_REGION_CCM].free + mem_heaps[MEM_REGION_SRAM].free;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void){
+	return mem_heaps[MEM_REGION_CCM].min_free + mem_heaps[MEM_REGION_SRAM].min_free;
+}
+
+void vPortInitialiseBlocks(void){
+	/* Not used - mem_heap_init() */
+}
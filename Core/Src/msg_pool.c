@@ -0,0 +1,105 @@
+/*
+ * msg_pool.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+
+#if (MSG_POOL_BLOCK_SIZE % 4)
+#error "MSG_POOL_BLOCK_SIZE must be a multiple of 4"
+#endif
+
+#if MSG_POOL_IN_CCMRAM
+#define MSG_POOL_SECTION	CCMRAM_NOINIT
+#else
+#define MSG_POOL_SECTION
+#endif
+
+/* Free block - the link is stored in the block itself */
+typedef struct msg_block{
+	struct msg_block* next;
+}msg_block_t;
+
+/* Pool storage - not initialized by the startup code, msg_pool_init() builds it */
+static uint32_t msg_pool_storage[MSG_POOL_BLOCKS][MSG_POOL_BLOCK_SIZE / 4] MSG_POOL_SECTION;
+
+static msg_block_t* msg_pool_free_list;
+
+msg_pool_stats_t msg_pool_stats;
+
+/**
+ * @brief This function links all the pool blocks to the free list
+ *
+ * @note Call before the scheduler starts
+ * */
+void msg_pool_init(void){
+	msg_block_t* block;
+	uint32_t i;
+
+	msg_pool_free_list = NULL;
+	for(i = 0; i < MSG_POOL_BLOCKS; i++){
+		block = (msg_block_t*)msg_pool_storage[i];
+		block->next = msg_pool_free_list;
+		msg_pool_free_list = block;
+	}
+
+	memset(&msg_pool_stats, 0, sizeof(msg_pool_stats));
+}
+
+/**
+ * @brief This function takes a block from the pool
+ *
+ * @return Pointer to a MSG_POOL_BLOCK_SIZE bytes block, NULL if the pool is exhausted
+ *
+ * @note O(1), can be called from a task or an ISR
+ * */
+void* msg_pool_alloc(void){
+	msg_block_t* block;
+	UBaseType_t mask;
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+
+	block = msg_pool_free_list;
+	if(block){
+		msg_pool_free_list = block->next;
+
+		msg_pool_stats.allocs++;
+		msg_pool_stats.used++;
+		if(msg_pool_stats.used > msg_pool_stats.used_max){
+			msg_pool_stats.used_max = msg_pool_stats.used;
+		}
+	}
+	else{
+		msg_pool_stats.alloc_fail++;
+	}
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+
+	return block;
+}
+
+/**
+ * @brief This function returns a block to the pool
+ *
+ * @param block Block taken by msg_pool_alloc()
+ *
+ * @note O(1), can be called from a task or an ISR. Matches the tx_release_t prototype.
+ * */
+void msg_pool_free(void* block){
+	msg_block_t* blk = block;
+	UBaseType_t mask;
+
+	if(blk == NULL){
+		return;
+	}
+
+	mask = taskENTER_CRITICAL_FROM_ISR();
+
+	blk->next = msg_pool_free_list;
+	msg_pool_free_list = blk;
+	msg_pool_stats.used--;
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+}
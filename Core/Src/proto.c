@@ -0,0 +1,378 @@
+/*
+ * proto.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "rtc_cache.h"
+#include "epoch.h"
+#include "clk_profile.h"
+#include "cobs.h"
+#include "ao.h"
+#include "proto.h"
+
+/* Response data - the frame without the header, the status and the CRC */
+#define PROTO_DATA_MAX		(PROTO_FRAME_MAX - PROTO_HDR_SIZE - 1 - PROTO_CRC_SIZE)
+
+/* Protocol signals */
+enum{
+	PROTO_SIG_FRAME = AO_SIG_USER,	/* request - data is the command_t holding the decoded frame */
+};
+
+proto_stats_t proto_stats;
+
+/* Requests handler - the highest priority active object */
+static ao_t proto_ao;
+static uint8_t proto_ao_storage[AO_QUEUE_STORAGE(CMD_POOL_SIZE)];
+
+/* A partial frame waits in the input ring since proto_rx_since */
+static uint32_t proto_rx_pending;
+static TickType_t proto_rx_since;
+
+/**
+ * @brief This function computes the frame CRC with the CRC peripheral
+ *
+ * @note Used by the dispatcher task only - the peripheral is not shared
+ * */
+static uint32_t proto_crc(const uint8_t* data, uint32_t len){
+	uint32_t word;
+
+	CRC->CR = CRC_CR_RESET;
+
+	while(len >= 4){
+		memcpy(&word, data, 4);
+		CRC->DR = word;
+		data += 4;
+		len -= 4;
+	}
+
+	if(len){
+		// Last word zero padded
+		word = 0;
+		memcpy(&word, data, len);
+		CRC->DR = word;
+	}
+
+	return CRC->DR;
+}
+
+static void proto_put_u32(uint8_t* p, uint32_t value){
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	p[2] = (uint8_t)(value >> 16);
+	p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t proto_get_u32(const uint8_t* p){
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief This function sets the RTC from Unix time
+ *
+ * @return PROTO_ERR_ARG out of the RTC calendar range
+ * */
+static proto_status_t proto_time_set(uint32_t secs){
+	RTC_TimeTypeDef sTime = {0};
+	RTC_DateTypeDef sDate = {0};
+
+	if(secs < epoch_days_from_civil(EPOCH_YEAR_MIN, 1, 1) * 86400U ||
+			secs > epoch_days_from_civil(EPOCH_YEAR_MAX, 12, 31) * 86400U + 86399U){
+		return PROTO_ERR_ARG;
+	}
+
+	epoch_to_rtc(secs, hrtc.Init.HourFormat, &sTime, &sDate);
+
+	HAL_RTC_SetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+	HAL_RTC_SetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+	rtc_cache_invalidate();
+
+	return PROTO_OK;
+}
+
+/**
+ * @brief This function executes a request
+ *
+ * @param cmd		The request command
+ * @param data		Request data
+ * @param len		Request data length
+ * @param rsp		Response data - PROTO_DATA_MAX bytes
+ * @param rsp_len	Response data length
+ *
+ * @return The response status
+ * */
+static proto_status_t proto_execute(uint8_t cmd, const uint8_t* data, uint32_t len, uint8_t* rsp, uint32_t* rsp_len){
+	uint64_t ms;
+
+	switch(cmd){
+		case PROTO_CMD_PING:
+			if(len > PROTO_DATA_MAX){
+				return PROTO_ERR_LEN;
+			}
+			memcpy(rsp, data, len);
+			*rsp_len = len;
+			return PROTO_OK;
+
+		case PROTO_CMD_INFO:
+			if(len){
+				return PROTO_ERR_LEN;
+			}
+			proto_put_u32(&rsp[0], xTaskGetTickCount());
+			proto_put_u32(&rsp[4], HAL_RCC_GetHCLKFreq());
+			rsp[8] = clk_profile_get();
+			rsp[9] = PROTO_FRAME_MAX;
+			*rsp_len = 10;
+			return PROTO_OK;
+
+		case PROTO_CMD_TIME_GET:
+			if(len){
+				return PROTO_ERR_LEN;
+			}
+			ms = rtc_cache_epoch_ms();
+			proto_put_u32(&rsp[0], (uint32_t)ms);
+			proto_put_u32(&rsp[4], (uint32_t)(ms >> 32));
+			*rsp_len = 8;
+			return PROTO_OK;
+
+		case PROTO_CMD_TIME_SET:
+			if(len != 4){
+				return PROTO_ERR_LEN;
+			}
+			return proto_time_set(proto_get_u32(data));
+
+		case PROTO_CMD_LED:
+			if(len != 1){
+				return PROTO_ERR_LEN;
+			}
+			if(data[0] > exec_e4){
+				return PROTO_ERR_ARG;
+			}
+			if(data[0] == exec_none){
+				leds_stop();
+			}
+			else{
+				leds_execute(data[0], NULL);
+			}
+			return PROTO_OK;
+
+		case PROTO_CMD_STATS:
+			if(len){
+				return PROTO_ERR_LEN;
+			}
+			proto_put_u32(&rsp[0], proto_stats.frames);
+			proto_put_u32(&rsp[4], proto_stats.crc_errors);
+			proto_put_u32(&rsp[8], proto_stats.bad_frames);
+			proto_put_u32(&rsp[12], proto_stats.dropped);
+			proto_put_u32(&rsp[16], proto_stats.timeouts);
+			proto_put_u32(&rsp[20], proto_stats.tx_dropped);
+			*rsp_len = 24;
+			return PROTO_OK;
+
+		default:
+			return PROTO_ERR_CMD;
+	}
+}
+
+/**
+ * @brief This function sends a response frame
+ *
+ * @param req		The request frame (sequence and command)
+ * @param status	Response status
+ * @param data		Response data
+ * @param len		Response data length (up to PROTO_DATA_MAX)
+ * */
+static void proto_respond(const uint8_t* req, proto_status_t status, const uint8_t* data, uint32_t len){
+	uint8_t frame[PROTO_FRAME_MAX];
+	uint8_t* msg;
+	uint32_t n;
+
+	frame[0] = PROTO_VERSION;
+	frame[1] = req[1];
+	frame[2] = req[2] | PROTO_RSP;
+	frame[3] = status;
+	memcpy(&frame[4], data, len);
+	len += 4;
+	proto_put_u32(&frame[len], proto_crc(frame, len));
+	len += PROTO_CRC_SIZE;
+
+	// The print task returns the block to the pool after transmission
+	msg = (uint8_t*)msg_pool_alloc();
+	if(msg == NULL){
+		proto_stats.tx_dropped++;
+		return;
+	}
+
+	msg[0] = PROTO_DELIM;
+	n = 1 + cobs_encode(frame, len, &msg[1]);
+	msg[n++] = PROTO_DELIM;
+
+	// The requests are not held by a busy console - the block is returned to the pool on failure
+	if(queue_send_buff(msg, n, msg_pool_free, pdMS_TO_TICKS(PROTO_TX_TIMEOUT_MS)) != pdTRUE){
+		proto_stats.tx_dropped++;
+	}
+}
+
+/**
+ * @brief This function is the requests event handler
+ * */
+static void proto_ao_handler(ao_t* me, const ao_event_t* e){
+	command_t* frame = (command_t*)e->data;
+	const uint8_t* req = (const uint8_t*)frame->payload;
+	uint8_t rsp[PROTO_DATA_MAX];
+	uint32_t rsp_len = 0;
+	uint32_t len = frame->len - PROTO_CRC_SIZE;
+	proto_status_t status;
+
+	if(proto_crc(req, len) != proto_get_u32(&req[len])){
+		// The sequence number can't be trusted - no response
+		proto_stats.crc_errors++;
+		cmd_release(frame);
+		return;
+	}
+
+	proto_stats.frames++;
+
+	if(req[0] != PROTO_VERSION){
+		status = PROTO_ERR_VERSION;
+	}
+	else{
+		status = proto_execute(req[2], &req[PROTO_HDR_SIZE], len - PROTO_HDR_SIZE, rsp, &rsp_len);
+	}
+
+	proto_respond(req, status, rsp, rsp_len);
+	cmd_release(frame);
+}
+
+/**
+ * @brief This function returns a byte of the ring data
+ * */
+static uint8_t proto_ring_byte(const ring_span_t* spans, uint32_t offset){
+	return (offset < spans[0].len) ? spans[0].data[offset] : spans[1].data[offset - spans[0].len];
+}
+
+/**
+ * @brief This function starts the CRC peripheral and the requests handler
+ *
+ * @note Call before the other active objects are started - the requests have the highest priority
+ * */
+void proto_init(void){
+	__HAL_RCC_CRC_CLK_ENABLE();
+
+	ao_start(&proto_ao, "Proto", proto_ao_handler, proto_ao_storage, CMD_POOL_SIZE);
+}
+
+/**
+ * @brief This function checks if the input ring starts with a binary frame
+ *
+ * @return Non zero value when the first byte is a frame delimiter
+ * */
+uint32_t proto_frame_start(const ring_buff_t* rb){
+	ring_span_t spans[2];
+
+	return ring_buff_peek(rb, 1, spans) && spans[0].data[0] == PROTO_DELIM;
+}
+
+/**
+ * @brief This function returns the time a partial frame may still wait for its end delimiter
+ *
+ * @return Ticks until proto_receive() takes the partial frame as text, portMAX_DELAY if there is none
+ *
+ * @note Command task
+ * */
+TickType_t proto_rx_wait(void){
+	TickType_t elapsed;
+
+	if(proto_rx_pending == 0){
+		return portMAX_DELAY;
+	}
+
+	elapsed = xTaskGetTickCount() - proto_rx_since;
+
+	return (elapsed < pdMS_TO_TICKS(PROTO_RX_TIMEOUT_MS)) ? pdMS_TO_TICKS(PROTO_RX_TIMEOUT_MS) - elapsed : 0;
+}
+
+/**
+ * @brief This function moves a binary frame from the input ring to a command slot and posts it
+ *
+ * @param rb The input ring - starts with a frame delimiter (proto_frame_start())
+ *
+ * @return Non zero value if there is no complete frame in the ring
+ *
+ * @note Command task. A partial frame waits for the rest up to PROTO_RX_TIMEOUT_MS - a stray zero byte
+ * 		 does not hold the text input. The task calls again when proto_rx_wait() expires.
+ * */
+int proto_receive(ring_buff_t* rb){
+	ao_event_t e = {PROTO_SIG_FRAME, 0, NULL, 0};
+	uint8_t enc[COBS_ENC_MAX(PROTO_FRAME_MAX)];
+	ring_span_t spans[2];
+	command_t* frame;
+	uint32_t count, start, end, len, i;
+	int32_t n;
+
+	count = ring_buff_count(rb);
+	ring_buff_peek(rb, count, spans);
+
+	// Skip the leading delimiters, find the end delimiter
+	for(start = 1; start < count && proto_ring_byte(spans, start) == PROTO_DELIM; start++);
+	for(end = start; end < count && proto_ring_byte(spans, end) != PROTO_DELIM; end++);
+
+	if(end == count){
+		if(ring_buff_free(rb) == 0){
+			// A full ring without the end delimiter can't become a valid frame - drop it
+			ring_buff_consume(rb, count);
+			proto_rx_pending = 0;
+			proto_stats.bad_frames++;
+		}
+		else if(proto_rx_pending == 0){
+			proto_rx_pending = 1;
+			proto_rx_since = xTaskGetTickCount();
+		}
+		else if(xTaskGetTickCount() - proto_rx_since >= pdMS_TO_TICKS(PROTO_RX_TIMEOUT_MS)){
+			// Not a frame - the rest is handled as text
+			ring_buff_consume(rb, start);
+			proto_rx_pending = 0;
+			proto_stats.timeouts++;
+			return 0;
+		}
+		return -1;
+	}
+
+	proto_rx_pending = 0;
+
+	len = end - start;
+	if(len > sizeof(enc)){
+		ring_buff_consume(rb, end + 1);
+		proto_stats.bad_frames++;
+		return 0;
+	}
+
+	for(i = 0; i < len; i++){
+		enc[i] = proto_ring_byte(spans, start + i);
+	}
+
+	// Release the frame and its delimiters
+	ring_buff_consume(rb, end + 1);
+
+	frame = cmd_alloc();
+	if(frame == NULL){
+		// No free slot - the client gets no response for this sequence
+		proto_stats.dropped++;
+		return 0;
+	}
+
+	n = cobs_decode(enc, len, (uint8_t*)frame->payload, sizeof(frame->payload));
+	if(n < PROTO_HDR_SIZE + PROTO_CRC_SIZE){
+		cmd_release(frame);
+		proto_stats.bad_frames++;
+		return 0;
+	}
+	frame->len = n;
+
+	// Can't fail - the queue holds all the command slots
+	e.data = frame;
+	ao_post(&proto_ao, &e);
+
+	return 0;
+}
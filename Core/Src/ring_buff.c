@@ -0,0 +1,168 @@
+/*
+ * ring_buff.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <string.h>
+#include "stm32f4xx.h"
+#include "ring_buff.h"
+
+/**
+ * @brief This function initializes an empty ring
+ *
+ * @param rb	Ring handle
+ * @param buff	Ring storage
+ * @param size	Storage size - must be a power of 2
+ * */
+void ring_buff_init(ring_buff_t* rb, uint8_t* buff, uint32_t size){
+	rb->buff = buff;
+	rb->mask = size - 1;
+	rb->head = 0;
+	rb->tail = 0;
+}
+
+/**
+ * @brief Number of bytes the producer can write
+ * */
+uint32_t ring_buff_free(const ring_buff_t* rb){
+	return (rb->mask + 1) - (rb->head - rb->tail);
+}
+
+/**
+ * @brief Number of bytes the consumer can read
+ * */
+uint32_t ring_buff_count(const ring_buff_t* rb){
+	return rb->head - rb->tail;
+}
+
+/**
+ * @brief This function copies data into the ring (producer side)
+ *
+ * @param rb	Ring handle
+ * @param data	Data to write
+ * @param len	Data length
+ *
+ * @return Number of bytes written - less than len when the ring is full
+ * */
+uint32_t ring_buff_write(ring_buff_t* rb, const uint8_t* data, uint32_t len){
+	uint32_t head = rb->head;
+	uint32_t idx = head & rb->mask;
+	uint32_t first;
+
+	if(len > ring_buff_free(rb)){
+		len = ring_buff_free(rb);
+	}
+
+	// Copy up to the storage end, then the rest from the storage start
+	first = rb->mask + 1 - idx;
+	if(first > len){
+		first = len;
+	}
+	memcpy(&rb->buff[idx], data, first);
+	memcpy(&rb->buff[0], &data[first], len - first);
+
+	// Publish the data before the index
+	__DMB();
+	rb->head = head + len;
+
+	return len;
+}
+
+/**
+ * @brief This function gives an in place view of the ring data (consumer side)
+ *
+ * @param rb	Ring handle
+ * @param len	Number of bytes to view
+ * @param spans	Output spans (two when the data wraps around)
+ *
+ * @return Number of valid spans (0 - 2)
+ * */
+uint32_t ring_buff_peek(const ring_buff_t* rb, uint32_t len, ring_span_t spans[2]){
+	uint32_t idx = rb->tail & rb->mask;
+	uint32_t first;
+	uint32_t n = 0;
+
+	if(len > ring_buff_count(rb)){
+		len = ring_buff_count(rb);
+	}
+	__DMB();
+
+	first = rb->mask + 1 - idx;
+	if(first > len){
+		first = len;
+	}
+
+	if(first){
+		spans[n].data = &rb->buff[idx];
+		spans[n++].len = first;
+	}
+	if(len - first){
+		spans[n].data = &rb->buff[0];
+		spans[n++].len = len - first;
+	}
+
+	return n;
+}
+
+/**
+ * @brief This function finds the first occurrence of a byte in the ring data
+ *
+ * @param rb	Ring handle
+ * @param ch	The byte to find
+ *
+ * @return Offset of the byte from the consumer index, -1 if not found
+ * */
+int32_t ring_buff_find(const ring_buff_t* rb, uint8_t ch){
+	ring_span_t spans[2];
+	uint32_t n, i;
+	uint32_t offset = 0;
+	const uint8_t* found;
+
+	n = ring_buff_peek(rb, ring_buff_count(rb), spans);
+
+	for(i = 0; i < n; i++){
+		found = memchr(spans[i].data, ch, spans[i].len);
+		if(found){
+			return offset + (found - spans[i].data);
+		}
+		offset += spans[i].len;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief This function releases data the consumer is done with
+ * */
+void ring_buff_consume(ring_buff_t* rb, uint32_t len){
+
+	if(len > ring_buff_count(rb)){
+		len = ring_buff_count(rb);
+	}
+
+	// Finish reading the data before the producer may overwrite it
+	__DMB();
+	rb->tail += len;
+}
+
+/**
+ * @brief This function copies data out of the ring and releases it
+ *
+ * @return Number of bytes read
+ * */
+uint32_t ring_buff_read(ring_buff_t* rb, uint8_t* data, uint32_t len){
+	ring_span_t spans[2];
+	uint32_t n, i;
+	uint32_t read = 0;
+
+	n = ring_buff_peek(rb, len, spans);
+	for(i = 0; i < n; i++){
+		memcpy(&data[read], spans[i].data, spans[i].len);
+		read += spans[i].len;
+	}
+
+	ring_buff_consume(rb, read);
+
+	return read;
+}
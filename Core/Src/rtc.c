@@ -5,22 +5,26 @@
  *      Author: vaknin
  */
 #include <stdint.h>
-#include <stdlib.h>
 
 #include "main.h"
+#include "msg_pool.h"
+#include "cmd_registry.h"
+#include "rtc_cache.h"
+#include "epoch.h"
+#include "rtc_report.h"
+#include "time_fmt.h"
+#include "dlog.h"
 
-void time_configure(void);
-void date_configure(void);
 void rtc_q_print_time(void);
 void rtc_report_time_stop(void);
 
-/* RTC message buffer */
-char rtc_time_buff[64] = {0};
-char rtc_time_buff_cb[64] = {0};
 
 /* Errors */
 static char* rtc_error_cmd      	 = "error: Invalid rtc input command\n";
 static char* rtc_error_invalid_state = "error: Invalid state\n";
+static char* rtc_error_iso8601  	 = "error: expected YYYY-MM-DDTHH:MM:SS\n";
+static char* rtc_error_datetime 	 = "error: Invalid date or time\n";
+static char* rtc_error_subs_full	 = "error: No free subscription\n";
 
 /* Messages */
 static char* rtc_hours_msg   = "Enter hours(0-23): ";
@@ -32,8 +36,6 @@ static char* rtc_weekDay_msg = "Enter day(1-7): ";
 static char* rtc_year_msg    = "Enter year(0-99): ";
 static char* rtc_report_msg  = "Enable reporting y/n ";
 
-char weekDays[7][4] = {"Sun","Mon","Tue","Wed","Thu", "Fri","Sat"};
-
 typedef enum {
 	Time_hhState,		/* hours update state   */
 	Time_mmState,		/* minutes update state */
@@ -49,91 +51,52 @@ typedef enum {
 	Date_stateTerm		/* Terminate state      */
 }eDateState_t;
 
-/**
- * @brief This function validate the date values
- *
- * @param state of the values update
- *
- * @return	pdFALSE if value exceeds
- *
- * */
-BaseType_t validate_date_value(uint32_t value, eDateState_t state){
-
-	switch(state){
-		case Date_ddState:
-			if(value < 1 || value > 31){
-				return pdFALSE;
-			}
-			break;
-		case Date_mmState:
-			if(value < 1 || value > 12){
-				return pdFALSE;
-			}
-			break;
-		case Date_wdState:
-			if(value < 1 || value > 7){
-				return pdFALSE;
-			}
-			break;
-		case Date_yyState:
-			if(value < 0 || value > 99){
-				return pdFALSE;
-			}
-			break;
-		case Date_stateTerm:
-			return pdTRUE;
-		default:
-			xQueueSend(q_print, &rtc_error_invalid_state, 0);
-			return pdFALSE;
-	}
-
-	return pdTRUE;
-}
-
-/**
- * @brief This function validate the time values
- *
- * @param state of the values update
- *
- * @return	pdFALSE if value exceeds
- *
- * */
-BaseType_t validate_time_value(uint32_t value, eTimeState_t state){
-
-	switch(state){
-		case Time_hhState:
-			if(value < 0 || value > 23){
-				return pdFALSE;
-			}
-			break;
-		case Time_mmState:
-			if(value < 0 || value > 59){
-				return pdFALSE;
-			}
-			break;
-		case Time_ssState:
-			if(value < 0 || value > 59){
-				return pdFALSE;
-			}
-			break;
-		case Time_stateTerm:
-			return pdTRUE;
-		default:
-			xQueueSend(q_print, &rtc_error_invalid_state, 0);
-			return pdFALSE;
-	}
-
-	return pdTRUE;
-}
+/* Arguments schema of the time configuration states (eTimeState_t) */
+static const arg_spec_t rtc_time_args[] = {
+	{ARG_INT, 0, 23, NULL},		/* hours   */
+	{ARG_INT, 0, 59, NULL},		/* minutes */
+	{ARG_INT, 0, 59, NULL},		/* seconds */
+};
+
+/* Arguments schema of the date configuration states (eDateState_t) */
+static const arg_spec_t rtc_date_args[] = {
+	{ARG_INT, 1, 31, NULL},		/* date    */
+	{ARG_INT, 1, 12, NULL},		/* month   */
+	{ARG_INT, 1, 7,  NULL},		/* weekday */
+	{ARG_INT, 0, 99, NULL},		/* year    */
+};
+
+/* Set date and time schema - YYYY-MM-DDTHH:MM:SS */
+static const arg_spec_t rtc_set_args = {ARG_STR, 0, 0, NULL};
+
+/* Subscription schemas - sub <seconds> <format>, unsub <id> */
+static const char* const rtc_report_formats[] = {"time", "epoch", "summary", NULL};	/* rtc_report_fmt_t */
+static const arg_spec_t rtc_sub_args[] = {
+	{ARG_INT, RTC_REPORT_PERIOD_MIN, RTC_REPORT_PERIOD_MAX, NULL},
+	{ARG_ENUM, 0, 0, rtc_report_formats},
+};
+static const arg_spec_t rtc_unsub_args = {ARG_INT, 0, RTC_REPORT_SUBS_MAX - 1, NULL};
+
+/* Report enable schema - y/n */
+static const char* const rtc_report_options[] = {"y", "n", NULL};
+static const arg_spec_t rtc_report_args = {ARG_ENUM, 0, 0, rtc_report_options};
+
+/* Time and date configuration in progress - one value per user input (rtc_input()) */
+static eTimeState_t rtc_time_state;
+static eDateState_t rtc_date_state;
+static RTC_TimeTypeDef rtc_time_cfg;
+static RTC_DateTypeDef rtc_date_cfg;
 
 /**
  * @brief This function reads the time from the rtc and print values to the console
  *
  * */
 void rtc_q_print_time(void){
-	RTC_TimeTypeDef sTimeCheck;
-	HAL_RTC_GetTime(&hrtc, &sTimeCheck, RTC_FORMAT_BIN);
-	printf("\nDebug: Hours: %02d, Minutes: %02d, Seconds: %02d\n", sTimeCheck.Hours, sTimeCheck.Minutes, sTimeCheck.Seconds);
+	rtc_snapshot_t snap;
+
+	rtc_cache_get(&snap);
+	DLOG("\nDebug: Hours: %02u, Minutes: %02u, Seconds: %02u.%06lu\n", snap.time.Hours, snap.time.Minutes,
+		 snap.time.Seconds, snap.subsec_us);
 }
 
 /**
@@ -142,99 +105,125 @@ void rtc_q_print_time(void){
  * */
 void rtc_q_print_time_n_date(void){
 
-	char* form;
-	uint8_t day_idx;
+	rtc_snapshot_t snap;
+	char* p;
+	char* end;
 
 	const char* hdr = "Current Time&Date ";
 
-	char* data = rtc_time_buff;
-
-	memset(rtc_time_buff, 0, sizeof(rtc_time_buff));
-
-	RTC_TimeTypeDef sTime;
-	RTC_DateTypeDef sDate;
-
-	memset(&sTime,0,sizeof(sTime));
-	memset(&sDate,0,sizeof(sDate));
-
-	HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
-
-	day_idx = sDate.WeekDay == RTC_WEEKDAY_SUNDAY ? 0 : sDate.WeekDay;
+	// The print task returns the block to the pool after transmission
+	char* data = msg_pool_alloc();
+	if(data == NULL){
+		return;
+	}
 
-	form = sTime.TimeFormat == RTC_HOURFORMAT12_AM ? "AM" : "PM";
+	rtc_cache_get(&snap);
 
-	// Display time in 12 hours format
-	if(hrtc.Init.HourFormat == RTC_HOURFORMAT_12){
-	    sprintf(data, "%02d:%02d:%02d [%s] [%s] %02d-%02d-%04d\n", sTime.Hours, sTime.Minutes,
-	    		sTime.Seconds, form, (char*)&weekDays[day_idx], sDate.Date, sDate.Month, 2000 + sDate.Year);
-	}
-	else{ // 24 hours format (No AM/PM)
-		sprintf(data, "%02d:%02d:%02d [%s] %02d-%02d-%04d\n", sTime.Hours, sTime.Minutes,
-				sTime.Seconds, (char*)&weekDays[day_idx], sDate.Date, sDate.Month, 2000 + sDate.Year);
-	}
+	// HH:MM:SS [AM] [Sun] DD-MM-YYYY - no AM/PM in 24 hours format
+	// Truncated at the block end, room for the new line
+	end = data + MSG_POOL_BLOCK_SIZE - 1;
+	p = time_fmt_time(data, end, &snap.time, hrtc.Init.HourFormat);
+	p = time_fmt_str(p, end, " [");
+	p = time_fmt_weekday(p, end, snap.date.WeekDay);
+	p = time_fmt_str(p, end, "] ");
+	p = time_fmt_date(p, end, &snap.date);
+	*p++ = '\n';
 
 	// Send message to queue
-	xQueueSend(q_print, &hdr, portMAX_DELAY);
+	queue_send_msg(hdr, portMAX_DELAY);
 	// Send message to queue
-	xQueueSend(q_print, &data, portMAX_DELAY);
+	queue_send_buff((uint8_t*)data, p - data, msg_pool_free, portMAX_DELAY);
 
 }
 
+/* The time and date report of the menu option */
+static int32_t rtc_report_menu_id = -1;
+
 /**
- * @brief Start rtc_timer
+ * @brief Start the periodic report
  *
  * */
 void rtc_report_time_start(void){
-	xTimerStart(rtc_timer, 0);
+	if(rtc_report_menu_id < 0){
+		rtc_report_menu_id = rtc_report_subscribe(1, RTC_REPORT_FMT_TIME);
+	}
 }
 
 /**
  * @brief This function handle the report time option
  *
- * @note Activates the rtc_timer for periodic reporting
+ * @param option The y/n answer
+ *
+ * @note Activates the RTC wakeup timer for periodic reporting
  * */
-void rtc_report_time_enable(void){
-	uint32_t cmd_value;
-	command_t* rx_cmd;
-
-	char option;
-
-	xQueueSend(q_print, &rtc_report_msg, portMAX_DELAY);
+static void rtc_report_time_enable(const arg_val_t* option){
 
-	xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
-
-	rx_cmd = (command_t*)cmd_value;
-
-	if(rx_cmd->len == 1){
-		// Get option
-		option = rx_cmd->payload[0];
+	if(option->idx == 0){
+		rtc_report_time_start();
 	}
 	else{
-		// Invalid input
-		xQueueSend(q_print, &rtc_error_cmd, 0);
-		return;
+		// Stop the report
+		rtc_report_time_stop();
 	}
+}
 
-	if(option == 'y' || option == 'Y'){
-		rtc_report_time_start();
-	}
-	else if(option == 'n' || option == 'N'){
-		// Stop rtc timer
-		rtc_report_time_stop();
+/**
+ * @brief This stops the periodic report
+ *
+ * */
+void rtc_report_time_stop(void){
+	rtc_report_unsubscribe(rtc_report_menu_id);
+	rtc_report_menu_id = -1;
+}
+
+/**
+ * @brief This function adds a periodic report - sub <seconds> <time|epoch|summary>
+ *
+ * @param args	args[0] - seconds between reports, args[1] - report format
+ *
+ * @return	Zero value - stay in the RTC menu
+ * */
+uint32_t rtc_report_sub_cmd(uint32_t param, const arg_val_t* args){
+	int32_t id;
+	char* msg;
+	char* p;
+	char* end;
+
+	id = rtc_report_subscribe(args[0].num, (rtc_report_fmt_t)args[1].idx);
+	if(id < 0){
+		queue_send_msg(rtc_error_subs_full, 0);
+		return 0;
 	}
-	else{
-		// Invalid Input
-		xQueueSend(q_print, &rtc_error_cmd, 0);
+
+	msg = msg_pool_alloc();
+	if(msg){
+		// Truncated at the block end, room for the new line
+		end = msg + MSG_POOL_BLOCK_SIZE - 1;
+		p = time_fmt_str(msg, end, "Subscription ");
+		p = time_fmt_u32(p, end, id);
+		*p++ = '\n';
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, 0);
 	}
+
+	return 0;
 }
 
 /**
- * @brief This stops the @rtc_timer
+ * @brief This function removes a periodic report - unsub <id>
+ *
+ * @param args	args[0] - subscription id
  *
+ * @return	Zero value - stay in the RTC menu
  * */
-void rtc_report_time_stop(void){
-	xTimerStop(rtc_timer, 0);
+uint32_t rtc_report_unsub_cmd(uint32_t param, const arg_val_t* args){
+
+	rtc_report_unsubscribe(args[0].num);
+
+	if(args[0].num == rtc_report_menu_id){
+		rtc_report_menu_id = -1;
+	}
+
+	return 0;
 }
 
 /**
@@ -268,230 +257,307 @@ void rtc_time_format_set(RTC_TimeTypeDef* sTime){
 }
 
 /**
- * @brief This function handle the time configuration
+ * @brief This function handle one value of the time configuration
  *
+ * @param value The value of the current state (rtc_time_state)
+ *
+ * @return	RTC_RET_PROMPT while values are missing, RTC_RET_MENU once the time is set
  * */
-void time_configure(void){
-	BaseType_t ret;
-	uint32_t cmd_value;
-	uint8_t value;
-	command_t* rx_cmd;
-
-	RTC_TimeTypeDef sTime = {0};
-
-	// init state
-	eTimeState_t time_state = Time_hhState;
-	char* rtc_time_msg =  rtc_hours_msg;
+static uint32_t time_configure(const arg_val_t* value){
 
-	do{
-		xQueueSend(q_print, &rtc_time_msg, portMAX_DELAY);
+	switch(rtc_time_state){
+		case Time_hhState:
+			rtc_time_cfg.Hours = value->num;
+			rtc_time_state = Time_mmState;
+			queue_send_msg(rtc_minutes_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+		case Time_mmState:
+			rtc_time_cfg.Minutes = value->num;
+			rtc_time_state = Time_ssState;
+			queue_send_msg(rtc_seconds_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+		case Time_ssState:
+			rtc_time_cfg.Seconds = value->num;
+			rtc_time_state = Time_stateTerm;
+			break;
+		default:
+			queue_send_msg(rtc_error_invalid_state, 0);
+			return RTC_RET_MENU;
+	}
 
-		xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
+	rtc_time_format_set(&rtc_time_cfg);
 
-		rx_cmd = (command_t*)cmd_value;
+	// Set the time
+	HAL_RTC_SetTime(&hrtc, &rtc_time_cfg, RTC_FORMAT_BIN);
+	rtc_cache_invalidate();
 
-		value = atoi((char*)rx_cmd->payload);
+	// Print the time&date after update
+	rtc_q_print_time_n_date();
+	rtc_q_print_time();
 
-		ret = validate_time_value(value, time_state);
-		if(ret == pdFALSE){
-			xQueueSend(q_print, &rtc_error_cmd, 0);
-			return;
-		}
+	return RTC_RET_MENU;
+}
 
-		switch(time_state){
-			case Time_hhState:
-				sTime.Hours = value;
-				time_state = Time_mmState;
-				rtc_time_msg = rtc_minutes_msg;
-				break;
-			case Time_mmState:
-				sTime.Minutes = value;
-				time_state = Time_ssState;
-				rtc_time_msg = rtc_seconds_msg;
-				break;
-			case Time_ssState:
-				sTime.Seconds = value;
-				time_state = Time_stateTerm;
-				break;
-			case Time_stateTerm:
-				break;
-			default:
-				time_state = Time_stateTerm;
-				xQueueSend(q_print, &rtc_error_invalid_state, 0);
-				return;;
-		}
-	}
-	while(time_state != Time_stateTerm);
+/**
+ * @brief This function handle one value of the date configuration
+ *
+ * @param value The value of the current state (rtc_date_state)
+ *
+ * @return	RTC_RET_PROMPT while values are missing, RTC_RET_MENU once the date is set
+ * */
+static uint32_t date_configure(const arg_val_t* value){
 
-	if(time_state != Time_stateTerm){
-		// User didn't send the time values as expected. do not set new time.
-		return;
+	switch(rtc_date_state){
+		case Date_ddState:
+			rtc_date_cfg.Date = value->num;
+			rtc_date_state = Date_mmState;
+			queue_send_msg(rtc_month_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+		case Date_mmState:
+			rtc_date_cfg.Month = value->num;
+			rtc_date_state = Date_yyState;
+			queue_send_msg(rtc_year_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+		case Date_yyState:
+			rtc_date_cfg.Year = value->num;
+			rtc_date_state = Date_wdState;
+			queue_send_msg(rtc_weekDay_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+		case Date_wdState:
+			rtc_date_cfg.WeekDay = (value->num + 6) % 7 ? ((value->num + 6) % 7) : 7;
+			rtc_date_state = Date_stateTerm;
+			break;
+		default:
+			queue_send_msg(rtc_error_invalid_state, 0);
+			return RTC_RET_MENU;
 	}
 
-	rtc_time_format_set(&sTime);
+	// Set the date
+	HAL_RTC_SetDate(&hrtc, &rtc_date_cfg, RTC_FORMAT_BIN);
+	rtc_cache_invalidate();
 
-	// Set the time
-	HAL_RTC_SetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+	// Print the time&date after update
+	rtc_q_print_time_n_date();
+	rtc_q_print_time();
 
+	return RTC_RET_MENU;
 }
 
 /**
- * @brief This function handle the date configuration
+ * @brief This function executes the rtc function
+ *
+ * @param	option excepted by the user
+ *
+ * @return	RTC_RET_EXIT when exit back to Main Menu
+ * 			RTC_RET_PROMPT when the option waits for a value (rtc_input())
+ * 			RTC_RET_MENU in all other options
  *
  * */
-void date_configure(void){
-	BaseType_t ret = pdTRUE;
-	uint32_t cmd_value;
-	uint8_t value;
-	command_t* rx_cmd;
+uint32_t rtc_execute(uint32_t option, const arg_val_t* args){
 
-	RTC_DateTypeDef sDate = {0};
+	switch(option){
+		case 0: // Configure the time
+			app_event(evTime);
+			rtc_time_state = Time_hhState;
+			memset(&rtc_time_cfg, 0, sizeof(rtc_time_cfg));
+			queue_send_msg(rtc_hours_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
+
+		case 1: // Configure the date
+			app_event(evDate);
+			rtc_date_state = Date_ddState;
+			memset(&rtc_date_cfg, 0, sizeof(rtc_date_cfg));
+			queue_send_msg(rtc_day_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
 
-	// init state
-	eDateState_t date_state = Date_ddState;
-	char* rtc_date_msg =  rtc_day_msg;
+		case 2:	// Enable reporting
+			app_event(evReport);
+			queue_send_msg(rtc_report_msg, portMAX_DELAY);
+			return RTC_RET_PROMPT;
 
-	do{
-		xQueueSend(q_print, &rtc_date_msg, portMAX_DELAY);
+		case 3:	// Exit
+			app_event(evBack);
+			return RTC_RET_EXIT;
 
-		xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
+		case 4: // Print time and date
+			// Add to queue
+			rtc_q_print_time_n_date();
 
-		rx_cmd = (command_t*)cmd_value;
+			// Debug
+			rtc_q_print_time();
 
-		value = atoi((char*)rx_cmd->payload);
+			return RTC_RET_MENU;
 
-		ret = validate_date_value(value, date_state);
-		if(ret == pdFALSE){
+		default:
 			// Invalid Input
-			xQueueSend(q_print, &rtc_error_cmd, 0);
-			return;
-		}
+			queue_send_msg(rtc_error_cmd, 0);
+			return RTC_RET_MENU;
+	}
+}
+
+/**
+ * @brief This function handles the user input of a value prompt (time, date or report configuration)
+ *
+ * @param payload	The user input
+ * @param len		Input length
+ *
+ * @return	RTC_RET_PROMPT while the configuration waits for more values, RTC_RET_MENU when it ends
+ *
+ * @note An invalid value ends the configuration, the RTC is not changed
+ * */
+uint32_t rtc_input(const char* payload, uint32_t len){
+	state_t state = app_state();
+	const arg_spec_t* spec;
+	arg_val_t value;
+	args_err_t err;
 
-		switch(date_state){
-			case Date_ddState:
-				sDate.Date = value;
-				date_state = Date_mmState;
-				rtc_date_msg = rtc_month_msg;
-				break;
-			case Date_mmState:
-				sDate.Month = value;
-				date_state = Date_yyState;
-				rtc_date_msg = rtc_year_msg;
-				break;
-			case Date_yyState:
-				sDate.Year = value;
-				date_state = Date_wdState;
-				rtc_date_msg = rtc_weekDay_msg;
-				break;
-			case Date_wdState:
-				sDate.WeekDay = (value + 6) % 7 ? ((value + 6) % 7) : 7;
-				date_state = Date_stateTerm;
-				break;
-			case Date_stateTerm:
-				break;
-			default:
-				date_state = Date_stateTerm;
-				xQueueSend(q_print, &rtc_error_invalid_state, 0);
-				return;
+	switch(state){
+		case sRtcTimeConfig:
+			spec = &rtc_time_args[rtc_time_state];
+			break;
+		case sRtcDateConfig:
+			spec = &rtc_date_args[rtc_date_state];
+			break;
+		case sRtcReport:
+			spec = &rtc_report_args;
+			break;
+		default:
+			queue_send_msg(rtc_error_invalid_state, 0);
+			return RTC_RET_MENU;
+	}
+
+	err = args_parse(payload, len, spec, 1, &value, NULL);
+	if(err != ARGS_OK){
+		queue_send_msg(args_err_msg(err), 0);
+		if(state != sRtcReport){
+			// User didn't send the values as expected - the time and date are not changed
+			rtc_q_print_time_n_date();
+			rtc_q_print_time();
 		}
+		return RTC_RET_MENU;
 	}
-	while(date_state != Date_stateTerm);
 
-	// Set the date
-	HAL_RTC_SetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+	if(state == sRtcTimeConfig){
+		return time_configure(&value);
+	}
+
+	if(state == sRtcDateConfig){
+		return date_configure(&value);
+	}
+
+	rtc_report_time_enable(&value);
+
+	return RTC_RET_MENU;
 }
 
 /**
- * @brief This function executes the rtc function
- *
- * @param	option excepted by the user
- *
- * @return	Non zero value when exit back to Main Menu
- * 			Zero value in all other options
+ * @brief This function parses a fixed width decimal field
  *
+ * @return The field value, -1 if a character is not a digit
  * */
-uint32_t rtc_execute(int option){
-
-	while(1){
-		switch(option){
-			case 0: // Configure the time
-				app_curr_state = sRtcTimeConfig;
-				time_configure();
-				option = 4;		// Print the time&date after update
-				break;
-
-			case 1: // Configure the date
-				app_curr_state = sRtcDateConfig;
-				date_configure();
-				option = 4;		// Print the time&date after update
-				break;
-
-			case 2:	// Enable reporting
-				app_curr_state = sRtcReport;
-				rtc_report_time_enable();
-				return 0;
-
-			case 3:	// Exit
-				app_curr_state = sMainMenu;
-				xTaskNotify(menu_task_handle, 0,eNoAction);
-				return 1;
-			case 4: // Print time and date
-				//dummy read
-				RTC_TimeTypeDef dummy = {0};
-				HAL_RTC_GetTime(&hrtc, &dummy, RTC_FORMAT_BIN);
-				RTC_DateTypeDef _dummy = {0};
-				HAL_RTC_GetDate(&hrtc, &_dummy, RTC_FORMAT_BIN);
-
-				// Add to queue
-				rtc_q_print_time_n_date();
-
-				// Debug
-				rtc_q_print_time();
-
-				return 0;
-			default:
-				// Invalid Input
-				xQueueSend(q_print, &rtc_error_cmd, 0);
-				return 0;
+static int32_t rtc_iso8601_field(const char* str, uint32_t width){
+	int32_t value = 0;
+	uint32_t digit;
+
+	while(width--){
+		digit = (uint32_t)(*str++ - '0');
+		if(digit > 9){
+			return -1;
 		}
+		value = value * 10 + digit;
 	}
 
-	return 0;
+	return value;
 }
 
 /**
- * @brief This function handle the timer interrupt callback
+ * @brief This function parses an ISO 8601 date and time - YYYY-MM-DDTHH:MM:SS
  *
- * @param	xTimer Timer handle
+ * @param str	Date and time string (not null terminated)
+ * @param len	String length
+ * @param ct	Parsed date and time, including the calculated weekday
  *
- * @note uncomment xQueueSend(q_print, &msg, portMAX_DELAY); to transmit to uart
+ * @return	ARGS_OK, ARGS_ERR_NOT_NUMBER on a format error or ARGS_ERR_RANGE on an invalid date or time
  * */
-void rtc_timer_callback(TimerHandle_t xTimer){
+static args_err_t rtc_iso8601_parse(const char* str, uint32_t len, civil_time_t* ct){
+	int32_t year, month, day, hours, minutes, seconds;
 
-	char* msg = rtc_time_buff_cb;
-	char* form;
+	if(len != 19 || str[4] != '-' || str[7] != '-' || (str[10] != 'T' && str[10] != 't')
+	   || str[13] != ':' || str[16] != ':'){
+		return ARGS_ERR_NOT_NUMBER;
+	}
 
-	RTC_TimeTypeDef sTime = {0};
-	RTC_DateTypeDef sDate = {0};
+	year    = rtc_iso8601_field(&str[0], 4);
+	month   = rtc_iso8601_field(&str[5], 2);
+	day     = rtc_iso8601_field(&str[8], 2);
+	hours   = rtc_iso8601_field(&str[11], 2);
+	minutes = rtc_iso8601_field(&str[14], 2);
+	seconds = rtc_iso8601_field(&str[17], 2);
 
-	HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+	if((year | month | day | hours | minutes | seconds) < 0){
+		return ARGS_ERR_NOT_NUMBER;
+	}
 
-	// Get Time format
-	form = sTime.TimeFormat == RTC_HOURFORMAT12_AM ? "AM" : "PM";
+	if(year < EPOCH_YEAR_MIN || year > EPOCH_YEAR_MAX || month < 1 || month > 12 || day < 1
+	   || (uint32_t)day > epoch_month_days(year, month)){
+		return ARGS_ERR_RANGE;
+	}
 
-	if(hrtc.Init.HourFormat == RTC_HOURFORMAT_12){
-		sprintf(rtc_time_buff_cb, "Current Time&Date %02d:%02d:%02d [%s] %02d-%02d-20%02d\n", sTime.Hours, sTime.Minutes,
-						sTime.Seconds, form, sDate.Date, sDate.Month, sDate.Year);
+	if(hours > 23 || minutes > 59 || seconds > 59){
+		return ARGS_ERR_RANGE;
 	}
-	else{
-		sprintf(rtc_time_buff_cb, "Current Time&Date %02d:%02d:%02d , %02d-%02d-20%02d\n", sTime.Hours, sTime.Minutes,
-						sTime.Seconds, sDate.Date, sDate.Month, sDate.Year);
+
+	ct->year    = year;
+	ct->month   = month;
+	ct->day     = day;
+	ct->weekday = epoch_weekday(epoch_days_from_civil(year, month, day));
+	ct->hours   = hours;
+	ct->minutes = minutes;
+	ct->seconds = seconds;
+
+	return ARGS_OK;
+}
+
+/**
+ * @brief This function sets the date and time in one command - set YYYY-MM-DDTHH:MM:SS
+ *
+ * @param args	args[0] - the ISO 8601 date and time string
+ *
+ * @return	Zero value - stay in the RTC menu
+ * */
+uint32_t rtc_set_datetime(uint32_t param, const arg_val_t* args){
+	RTC_TimeTypeDef sTime = {0};
+	RTC_DateTypeDef sDate = {0};
+	civil_time_t ct;
+	args_err_t err;
+
+	err = rtc_iso8601_parse(args[0].str.ptr, args[0].str.len, &ct);
+	if(err != ARGS_OK){
+		queue_send_msg(err == ARGS_ERR_RANGE ? rtc_error_datetime : rtc_error_iso8601, 0);
+		return 0;
 	}
 
-	// Report to uart - uncomment this line!
-	//xQueueSend(q_print, &msg, portMAX_DELAY);
+	epoch_civil_to_rtc(&ct, hrtc.Init.HourFormat, &sTime, &sDate);
+
+	// Program the RTC once - no prompt round trips between the time and date updates
+	HAL_RTC_SetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+	HAL_RTC_SetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+	rtc_cache_invalidate();
+
+	rtc_q_print_time_n_date();
 
-	// Report to console
-	printf("%s", rtc_time_buff_cb);
+	return 0;
 }
+
+/* RTC menu commands */
+const cmd_entry_t rtc_cmds[] = {
+	{CMD_GROUP_RTC, "0", 0, NULL, rtc_execute, 0},	/* Configure time */
+	{CMD_GROUP_RTC, "1", 0, NULL, rtc_execute, 1},	/* Configure date */
+	{CMD_GROUP_RTC, "2", 0, NULL, rtc_execute, 2},	/* Enable reporting */
+	{CMD_GROUP_RTC, "3", 0, NULL, rtc_execute, 3},	/* Exit */
+	{CMD_GROUP_RTC, "4", 0, NULL, rtc_execute, 4},	/* Print time and date */
+	{CMD_GROUP_RTC, "set", 1, &rtc_set_args, rtc_set_datetime, 0},	/* Set date and time */
+	{CMD_GROUP_RTC, "sub", 2, rtc_sub_args, rtc_report_sub_cmd, 0},			/* Add a periodic report */
+	{CMD_GROUP_RTC, "unsub", 1, &rtc_unsub_args, rtc_report_unsub_cmd, 0},	/* Remove a periodic report */
+	{0}
+};
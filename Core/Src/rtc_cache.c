@@ -0,0 +1,155 @@
+/*
+ * rtc_cache.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "rtc_cache.h"
+#include "epoch.h"
+
+#define RTC_CACHE_US_PER_TICK	(1000000U / configTICK_RATE_HZ)
+
+/* The last coherent snapshot and the tick count when it was read */
+static rtc_snapshot_t rtc_cache;
+static uint32_t rtc_cache_tr, rtc_cache_dr;		/* the raw second of the snapshot */
+static TickType_t rtc_cache_tick;
+static uint32_t rtc_cache_valid;
+
+/* The last returned time - the second (raw TR, DR) and the sub second part */
+static uint32_t rtc_cache_last_tr, rtc_cache_last_dr;
+static uint32_t rtc_cache_last_us;
+static uint32_t rtc_cache_last_valid;
+
+rtc_cache_stats_t rtc_cache_stats;
+
+/**
+ * @brief This function reads the RTC calendar into the cache
+ *
+ * @note Reading SSR first locks TR and DR in the shadow registers until DR is read (BYPSHAD = 0),
+ * 		 so the three registers always belong to the same second.
+ * */
+static void rtc_cache_read(void){
+	uint32_t ssr, tr, dr, prediv_s;
+
+	ssr = hrtc.Instance->SSR & RTC_SSR_SS;
+	tr = hrtc.Instance->TR & RTC_TR_RESERVED_MASK;
+	dr = hrtc.Instance->DR & RTC_DR_RESERVED_MASK;
+	prediv_s = hrtc.Instance->PRER & RTC_PRER_PREDIV_S;
+
+	rtc_cache.time.Hours      = RTC_Bcd2ToByte((tr & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos);
+	rtc_cache.time.Minutes    = RTC_Bcd2ToByte((tr & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos);
+	rtc_cache.time.Seconds    = RTC_Bcd2ToByte(tr & (RTC_TR_ST | RTC_TR_SU));
+	rtc_cache.time.TimeFormat = (tr & RTC_TR_PM) >> RTC_TR_PM_Pos;
+	rtc_cache.time.SubSeconds = ssr;
+	rtc_cache.time.SecondFraction = prediv_s;
+
+	rtc_cache.date.Year    = RTC_Bcd2ToByte((dr & (RTC_DR_YT | RTC_DR_YU)) >> RTC_DR_YU_Pos);
+	rtc_cache.date.Month   = RTC_Bcd2ToByte((dr & (RTC_DR_MT | RTC_DR_MU)) >> RTC_DR_MU_Pos);
+	rtc_cache.date.Date    = RTC_Bcd2ToByte(dr & (RTC_DR_DT | RTC_DR_DU));
+	rtc_cache.date.WeekDay = (dr & RTC_DR_WDU) >> RTC_DR_WDU_Pos;
+
+	// SS counts down from PREDIV_S (it may exceed it right after a shift operation)
+	if(ssr > prediv_s){
+		ssr = prediv_s;
+	}
+	rtc_cache.subsec_us = (uint32_t)(((uint64_t)(prediv_s - ssr) * 1000000U) / (prediv_s + 1));
+
+	rtc_cache_tr = tr;
+	rtc_cache_dr = dr;
+	rtc_cache_tick = xTaskGetTickCount();
+	rtc_cache_valid = 1;
+	rtc_cache_stats.reads++;
+}
+
+/**
+ * @brief This function returns the current time and date
+ *
+ * @param snap Coherent time, date and sub second snapshot
+ *
+ * @note The RTC is read once per second, the sub second part is advanced by the RTOS tick in between.
+ * 		 The tick (HSE) runs faster than the RTC (LSI) - the time returned never goes back.
+ * */
+void rtc_cache_get(rtc_snapshot_t* snap){
+	TickType_t elapsed;
+	uint32_t subsec_us = 0;
+
+	taskENTER_CRITICAL();
+
+	elapsed = xTaskGetTickCount() - rtc_cache_tick;
+	if(rtc_cache_valid && elapsed < configTICK_RATE_HZ){
+		subsec_us = rtc_cache.subsec_us + elapsed * RTC_CACHE_US_PER_TICK;
+	}
+
+	// Refresh at the second boundary
+	if(rtc_cache_valid == 0 || elapsed >= configTICK_RATE_HZ || subsec_us >= 1000000U){
+		rtc_cache_read();
+		subsec_us = rtc_cache.subsec_us;
+	}
+	else{
+		rtc_cache_stats.hits++;
+	}
+
+	// Ahead of the RTC in the same second - hold the last time until the RTC catches up
+	if(rtc_cache_last_valid && rtc_cache_tr == rtc_cache_last_tr && rtc_cache_dr == rtc_cache_last_dr
+			&& subsec_us < rtc_cache_last_us){
+		subsec_us = rtc_cache_last_us;
+	}
+
+	rtc_cache_last_tr = rtc_cache_tr;
+	rtc_cache_last_dr = rtc_cache_dr;
+	rtc_cache_last_us = subsec_us;
+	rtc_cache_last_valid = 1;
+
+	*snap = rtc_cache;
+	snap->subsec_us = subsec_us;
+
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief This function returns the time of day in microseconds
+ *
+ * @return Microseconds since midnight (24 hours)
+ * */
+uint64_t rtc_cache_day_us(void){
+	rtc_snapshot_t snap;
+	uint32_t hours;
+
+	rtc_cache_get(&snap);
+
+	hours = snap.time.Hours;
+	if(hrtc.Init.HourFormat == RTC_HOURFORMAT_12){
+		hours %= 12;
+		if(snap.time.TimeFormat == RTC_HOURFORMAT12_PM){
+			hours += 12;
+		}
+	}
+
+	return (uint64_t)((hours * 60 + snap.time.Minutes) * 60 + snap.time.Seconds) * 1000000U + snap.subsec_us;
+}
+
+/**
+ * @brief This function returns the Unix time in milliseconds
+ *
+ * @return Milliseconds since 1970-01-01 00:00:00 (the RTC holds UTC)
+ * */
+uint64_t rtc_cache_epoch_ms(void){
+	rtc_snapshot_t snap;
+
+	rtc_cache_get(&snap);
+
+	return (uint64_t)epoch_from_rtc(&snap.time, &snap.date, hrtc.Init.HourFormat) * 1000U + snap.subsec_us / 1000U;
+}
+
+/**
+ * @brief This function drops the cached snapshot
+ *
+ * @note Call after the time or the date is set - the time may go back
+ * */
+void rtc_cache_invalidate(void){
+	taskENTER_CRITICAL();
+	rtc_cache_valid = 0;
+	rtc_cache_last_valid = 0;
+	taskEXIT_CRITICAL();
+}
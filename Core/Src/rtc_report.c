@@ -0,0 +1,347 @@
+/*
+ * rtc_report.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "msg_pool.h"
+#include "rtc_cache.h"
+#include "rtc_report.h"
+#include "epoch.h"
+#include "time_fmt.h"
+#include "dlog.h"
+
+#define RTC_WHEEL_MASK		(RTC_WHEEL_SLOTS - 1)
+
+#if (RTC_REPORT_PERIOD_MAX >= (1 << (RTC_WHEEL_BITS * RTC_WHEEL_LEVELS)))
+#error "The timing wheel does not cover RTC_REPORT_PERIOD_MAX"
+#endif
+
+/* Report subscription - linked in a timing wheel slot */
+typedef struct rtc_sub{
+	struct rtc_sub* next;
+	struct rtc_sub** pprev;		/* the link pointing to this entry, NULL when not in the wheel */
+	uint32_t expires;			/* wheel time (seconds) of the next report */
+	uint32_t period;
+	rtc_report_fmt_t fmt;
+	uint32_t used;
+}rtc_sub_t;
+
+static rtc_sub_t rtc_subs[RTC_REPORT_SUBS_MAX];
+
+/* Hierarchical timing wheel - level n slot holds the entries expiring within 64^(n + 1) seconds */
+static rtc_sub_t* rtc_wheel[RTC_WHEEL_LEVELS][RTC_WHEEL_SLOTS];
+static uint32_t rtc_wheel_now;
+
+rtc_report_stats_t rtc_report_stats;
+
+/**
+ * @brief This function links a subscription to the wheel slot of its expiry time
+ * */
+static void rtc_wheel_add(rtc_sub_t* sub){
+	uint32_t delta = sub->expires - rtc_wheel_now;
+	uint32_t level = 0;
+	rtc_sub_t** head;
+
+	while(level < RTC_WHEEL_LEVELS - 1 && delta >= (1U << (RTC_WHEEL_BITS * (level + 1)))){
+		level++;
+	}
+
+	head = &rtc_wheel[level][(sub->expires >> (RTC_WHEEL_BITS * level)) & RTC_WHEEL_MASK];
+
+	sub->next = *head;
+	if(sub->next){
+		sub->next->pprev = &sub->next;
+	}
+	*head = sub;
+	sub->pprev = head;
+}
+
+/**
+ * @brief This function unlinks a subscription from the wheel
+ * */
+static void rtc_wheel_del(rtc_sub_t* sub){
+
+	if(sub->pprev == NULL){
+		return;
+	}
+
+	*sub->pprev = sub->next;
+	if(sub->next){
+		sub->next->pprev = sub->pprev;
+	}
+	sub->pprev = NULL;
+}
+
+/**
+ * @brief This function moves the entries of a higher level slot to the lower levels
+ * */
+static void rtc_wheel_cascade(uint32_t level){
+	rtc_sub_t* sub = rtc_wheel[level][(rtc_wheel_now >> (RTC_WHEEL_BITS * level)) & RTC_WHEEL_MASK];
+	rtc_sub_t* next;
+
+	while(sub){
+		next = sub->next;
+		rtc_wheel_del(sub);
+		rtc_wheel_add(sub);
+		sub = next;
+	}
+}
+
+/**
+ * @brief This function advances the wheel by one second
+ *
+ * @param fired	The formats of the expired subscriptions
+ *
+ * @return The number of expired subscriptions
+ *
+ * @note O(1) per tick - only the current slot is visited, the higher levels cascade once per 64 ticks.
+ * 		 Call in a critical section.
+ * */
+static uint32_t rtc_wheel_tick(rtc_report_fmt_t* fired){
+	rtc_sub_t* sub;
+	rtc_sub_t* next;
+	uint32_t level;
+	uint32_t n = 0;
+
+	rtc_wheel_now++;
+
+	// Cascade the higher levels when the lower level wraps
+	for(level = 1; level < RTC_WHEEL_LEVELS; level++){
+		if(rtc_wheel_now & ((1U << (RTC_WHEEL_BITS * level)) - 1)){
+			break;
+		}
+		rtc_wheel_cascade(level);
+	}
+
+	sub = rtc_wheel[0][rtc_wheel_now & RTC_WHEEL_MASK];
+	while(sub){
+		next = sub->next;
+
+		if(sub->expires == rtc_wheel_now){
+			fired[n++] = sub->fmt;
+
+			// Next period
+			rtc_wheel_del(sub);
+			sub->expires += sub->period;
+			rtc_wheel_add(sub);
+		}
+
+		sub = next;
+	}
+
+	return n;
+}
+
+/**
+ * @brief This function adds a periodic report
+ *
+ * @param period	Seconds between reports (RTC_REPORT_PERIOD_MIN - RTC_REPORT_PERIOD_MAX)
+ * @param fmt		Report format
+ *
+ * @return The subscription id, -1 if the table is full
+ *
+ * @note The RTC wakeup timer (1 Hz, aligned to the second edge) runs while there are subscriptions
+ * */
+int32_t rtc_report_subscribe(uint32_t period, rtc_report_fmt_t fmt){
+	rtc_sub_t* sub;
+	uint32_t first;
+	int32_t id;
+
+	configASSERT(period >= RTC_REPORT_PERIOD_MIN && period <= RTC_REPORT_PERIOD_MAX);
+	configASSERT(fmt < RTC_REPORT_FMT_NUM);
+
+	taskENTER_CRITICAL();
+
+	for(id = 0; id < RTC_REPORT_SUBS_MAX; id++){
+		if(rtc_subs[id].used == 0){
+			break;
+		}
+	}
+
+	if(id == RTC_REPORT_SUBS_MAX){
+		taskEXIT_CRITICAL();
+		return -1;
+	}
+
+	sub = &rtc_subs[id];
+	sub->used = 1;
+	sub->period = period;
+	sub->fmt = fmt;
+	sub->expires = rtc_wheel_now + period;
+	rtc_wheel_add(sub);
+
+	first = (rtc_report_stats.subs++ == 0);
+
+	taskEXIT_CRITICAL();
+
+	if(first){
+		// Wakeup every second - the counter counts the 1 Hz calendar clock (ck_spre)
+		HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, 0, RTC_WAKEUPCLOCK_CK_SPRE_16BITS);
+	}
+
+	return id;
+}
+
+/**
+ * @brief This function removes a periodic report
+ *
+ * @param id The subscription id
+ * */
+void rtc_report_unsubscribe(int32_t id){
+	uint32_t last;
+
+	if(id < 0 || id >= RTC_REPORT_SUBS_MAX){
+		return;
+	}
+
+	taskENTER_CRITICAL();
+
+	if(rtc_subs[id].used == 0){
+		taskEXIT_CRITICAL();
+		return;
+	}
+
+	rtc_wheel_del(&rtc_subs[id]);
+	rtc_subs[id].used = 0;
+
+	last = (--rtc_report_stats.subs == 0);
+
+	taskEXIT_CRITICAL();
+
+	if(last){
+		HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+	}
+}
+
+/**
+ * @brief This function formats the time and date line
+ *
+ * @return The end of the message
+ * */
+static char* rtc_report_format_time(char* p, const char* end){
+	rtc_snapshot_t snap;
+
+	rtc_cache_get(&snap);
+
+	// Current Time&Date HH:MM:SS [AM] DD-MM-YYYY, "HH:MM:SS , DD-MM-YYYY" in 24 hours format
+	p = time_fmt_str(p, end, "Current Time&Date ");
+	p = time_fmt_time(p, end, &snap.time, hrtc.Init.HourFormat);
+	if(hrtc.Init.HourFormat != RTC_HOURFORMAT_12){
+		p = time_fmt_str(p, end, " ,");
+	}
+	p = time_fmt_chr(p, end, ' ');
+
+	return time_fmt_date(p, end, &snap.date);
+}
+
+/**
+ * @brief This function formats and prints a report
+ *
+ * @param fmt Report format
+ *
+ * @note The report goes to the console UART and to the deferred log. It never waits for the print
+ * 		 queue - a report without a message block or room in the queue is dropped and counted.
+ * */
+static void rtc_report_print(rtc_report_fmt_t fmt){
+
+	rtc_snapshot_t snap;
+	char* msg;
+	char* p;
+	char* end;
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		rtc_report_stats.dropped++;
+		return;
+	}
+
+	// Truncated at MSG_POOL_BLOCK_SIZE - 1 - room for the new line
+	end = msg + MSG_POOL_BLOCK_SIZE - 1;
+	switch(fmt){
+		case RTC_REPORT_FMT_TIME:
+			p = rtc_report_format_time(msg, end);
+			break;
+		case RTC_REPORT_FMT_EPOCH:
+			// HB <seconds>.<milliseconds>
+			rtc_cache_get(&snap);
+			p = time_fmt_str(msg, end, "HB ");
+			p = time_fmt_u32(p, end, epoch_from_rtc(&snap.time, &snap.date, hrtc.Init.HourFormat));
+			p = time_fmt_chr(p, end, '.');
+			p = time_fmt_u32_pad(p, end, snap.subsec_us / 1000, 3);
+			break;
+		case RTC_REPORT_FMT_SUMMARY:
+		default:
+			// Sum up=<s> r=<reports> m=<missed> d=<dropped> s=<subs>
+			p = time_fmt_str(msg, end, "Sum up=");
+			p = time_fmt_u32(p, end, xTaskGetTickCount() / configTICK_RATE_HZ);
+			p = time_fmt_str(p, end, " r=");
+			p = time_fmt_u32(p, end, rtc_report_stats.reports);
+			p = time_fmt_str(p, end, " m=");
+			p = time_fmt_u32(p, end, rtc_report_stats.missed);
+			p = time_fmt_str(p, end, " d=");
+			p = time_fmt_u32(p, end, rtc_report_stats.dropped);
+			p = time_fmt_str(p, end, " s=");
+			p = time_fmt_u32(p, end, rtc_report_stats.subs);
+			break;
+	}
+	*p++ = '\n';
+
+	// Trace - the record holds a copy, drained to the ITM in the background
+	DLOG_BUF("%s", msg, p - msg);
+
+	// Console - the print task returns the block to the pool after transmission
+	if(queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, 0) != pdTRUE){
+		rtc_report_stats.dropped++;
+		return;
+	}
+
+	rtc_report_stats.reports++;
+}
+
+/**
+ * @brief This function is the RTC report task handler
+ *
+ * @param parameters
+ *
+ * @note Waits for the wakeup events, the formatting and the printing are done here and not in the ISR
+ * */
+void rtc_report_task_handler(void* params){
+	rtc_report_fmt_t fired[RTC_REPORT_SUBS_MAX];
+	uint32_t events;
+	uint32_t n, i;
+
+	while(1){
+		events = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		rtc_report_stats.events += events;
+		rtc_report_stats.missed += events - 1;
+
+		// Advance the wheel by every elapsed second - a late report is still printed
+		while(events--){
+			taskENTER_CRITICAL();
+			n = rtc_wheel_tick(fired);
+			taskEXIT_CRITICAL();
+
+			for(i = 0; i < n; i++){
+				rtc_report_print(fired[i]);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Wakeup timer event callback
+ *
+ * @param hrtc RTC handle
+ *
+ * @note Runs in the RTC_WKUP interrupt - only signals the report task
+ * */
+void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc){
+	BaseType_t woken = pdFALSE;
+
+	vTaskNotifyGiveFromISR(rtc_report_task_handle, &woken);
+
+	portYIELD_FROM_ISR(woken);
+}
@@ -0,0 +1,257 @@
+/*
+ * stack_mon.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stddef.h>
+#include "main.h"
+#include "semphr.h"
+#include "msg_pool.h"
+#include "time_fmt.h"
+#include "stack_mon.h"
+
+/* Task stack record - matched by name, the handles change between resets */
+typedef struct{
+	char name[configMAX_TASK_NAME_LEN];
+	uint32_t size;			/* words */
+	uint32_t min_free;		/* words - the lowest high-water mark */
+	uint32_t overflows;
+}stack_mon_entry_t;
+
+/* Persistent table - valid when the magic and the checksum match */
+typedef struct{
+	uint32_t magic;
+	uint32_t boots;
+	stack_mon_entry_t entries[TRACE_TASKS_MAX];
+	uint32_t check;
+}stack_mon_table_t;
+
+/* Stack size per task number (words) - recorded by traceTASK_CREATE() */
+uint32_t stack_mon_sizes[TRACE_TASKS_MAX];
+
+static stack_mon_table_t stack_mon_table CCMRAM_NOINIT;
+
+/* Sampling buffer - used under stack_mon_lock */
+static TaskStatus_t stack_mon_tasks[TRACE_TASKS_MAX];
+static SemaphoreHandle_t stack_mon_lock;
+static StaticSemaphore_t stack_mon_lock_struct;
+
+/**
+ * @brief This function computes the table checksum
+ * */
+static uint32_t stack_mon_checksum(void){
+	const uint32_t* w = (const uint32_t*)&stack_mon_table;
+	uint32_t sum = 0;
+	uint32_t i;
+
+	for(i = 0; i < offsetof(stack_mon_table_t, check) / 4; i++){
+		sum = (sum << 1 | sum >> 31) ^ w[i];
+	}
+
+	return sum;
+}
+
+/**
+ * @brief This function finds the record of a task, adds a new record if not found
+ *
+ * @return The record, NULL if the table is full
+ * */
+static stack_mon_entry_t* stack_mon_entry(const char* name){
+	stack_mon_entry_t* entry;
+	uint32_t i;
+
+	for(i = 0; i < TRACE_TASKS_MAX; i++){
+		entry = &stack_mon_table.entries[i];
+
+		if(entry->name[0] == '\0'){
+			strncpy(entry->name, name, configMAX_TASK_NAME_LEN - 1);
+			return entry;
+		}
+
+		if(strncmp(entry->name, name, configMAX_TASK_NAME_LEN) == 0){
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief This function updates the table with the stack high-water mark of all the tasks
+ *
+ * @note Call with stack_mon_lock taken
+ * */
+static void stack_mon_update(void){
+	stack_mon_entry_t* entry;
+	uint32_t count;
+	uint32_t size;
+	uint32_t i;
+
+	count = uxTaskGetSystemState(stack_mon_tasks, TRACE_TASKS_MAX, NULL);
+
+	taskENTER_CRITICAL();
+
+	for(i = 0; i < count; i++){
+		entry = stack_mon_entry(stack_mon_tasks[i].pcTaskName);
+		if(entry == NULL){
+			continue;
+		}
+
+		// A new stack size (new firmware) - the old minimum does not apply
+		size = stack_mon_sizes[stack_mon_tasks[i].xTaskNumber & (TRACE_TASKS_MAX - 1)];
+		if(entry->size != size){
+			entry->size = size;
+			entry->min_free = size;
+		}
+
+		if(stack_mon_tasks[i].usStackHighWaterMark < entry->min_free){
+			entry->min_free = stack_mon_tasks[i].usStackHighWaterMark;
+		}
+	}
+
+	stack_mon_table.check = stack_mon_checksum();
+
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief This function loads the persistent table
+ *
+ * @note Call before the scheduler starts
+ * */
+void stack_mon_init(void){
+
+	// Power on or a corrupted table - start over
+	if(stack_mon_table.magic != STACK_MON_MAGIC || stack_mon_table.check != stack_mon_checksum()){
+		memset(&stack_mon_table, 0, sizeof(stack_mon_table));
+		stack_mon_table.magic = STACK_MON_MAGIC;
+	}
+
+	stack_mon_table.boots++;
+	stack_mon_table.check = stack_mon_checksum();
+
+	stack_mon_lock = xSemaphoreCreateMutexStatic(&stack_mon_lock_struct);
+	configASSERT(stack_mon_lock);
+}
+
+/**
+ * @brief This function samples the stacks at most every STACK_MON_PERIOD_MS
+ *
+ * @note Called by the idle hook - samples while the system is awake, a periodic timer would end every
+ * 		 STOP sleep. The idle task must not block - a report holds the lock (and samples), skip this sample.
+ * */
+void stack_mon_idle(void){
+	static TickType_t last;
+
+	if(xTaskGetTickCount() - last < pdMS_TO_TICKS(STACK_MON_PERIOD_MS)){
+		return;
+	}
+
+	if(xSemaphoreTake(stack_mon_lock, 0) != pdTRUE){
+		return;
+	}
+
+	last = xTaskGetTickCount();
+	stack_mon_update();
+
+	xSemaphoreGive(stack_mon_lock);
+}
+
+/**
+ * @brief This function samples the stack high-water mark of all the tasks
+ *
+ * @note Task context. Walks the free stack space of every task - keep the period long.
+ * */
+void stack_mon_sample(void){
+	xSemaphoreTake(stack_mon_lock, portMAX_DELAY);
+
+	stack_mon_update();
+
+	xSemaphoreGive(stack_mon_lock);
+}
+
+/**
+ * @brief This function records a stack overflow in the persistent table
+ *
+ * @param name The task name
+ *
+ * @note Called by the stack overflow hook - the system halts afterwards
+ * */
+void stack_mon_overflow(const char* name){
+	stack_mon_entry_t* entry;
+
+	entry = stack_mon_entry(name);
+	if(entry){
+		entry->overflows++;
+		entry->min_free = 0;
+	}
+
+	stack_mon_table.check = stack_mon_checksum();
+}
+
+/**
+ * @brief This function prints the stack usage of the tasks and the recommended stack sizes
+ *
+ * @param timeout Queue send timeout
+ *
+ * @note The values are in words - the xTaskCreate() stack depth unit
+ * */
+void stack_mon_report(TickType_t timeout){
+	stack_mon_entry_t* entry;
+	uint32_t used, rec;
+	uint32_t i;
+	char* msg;
+	char* p;
+	char* end;
+
+	stack_mon_sample();
+
+	msg = msg_pool_alloc();
+	if(msg == NULL){
+		return;
+	}
+
+	end = msg + MSG_POOL_BLOCK_SIZE;
+	p = time_fmt_str(msg, end, "Stack words, boot ");
+	p = time_fmt_u32(p, end, stack_mon_table.boots);
+	p = time_fmt_str(p, end, "\nTask        Size  Used   Rec\n");
+	queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+
+	for(i = 0; i < TRACE_TASKS_MAX; i++){
+		entry = &stack_mon_table.entries[i];
+		if(entry->name[0] == '\0'){
+			break;
+		}
+
+		msg = msg_pool_alloc();
+		if(msg == NULL){
+			return;
+		}
+
+		// Max used + margin, rounded up to 8 words (the stack alignment)
+		used = entry->size - entry->min_free;
+		rec = used + used * STACK_MON_MARGIN_PCT / 100;
+		rec = (rec + 7) & ~7U;
+		if(rec < configMINIMAL_STACK_SIZE){
+			rec = configMINIMAL_STACK_SIZE;
+		}
+
+		// Truncated at the block end, room for the new line
+		end = msg + MSG_POOL_BLOCK_SIZE - 1;
+		p = time_fmt_str(msg, end, entry->name);
+		while(p < msg + configMAX_TASK_NAME_LEN){
+			*p++ = ' ';
+		}
+		p = time_fmt_u32_align(p, end, entry->size, 6);
+		p = time_fmt_u32_align(p, end, used, 6);
+		p = time_fmt_u32_align(p, end, rec, 6);
+		if(entry->overflows){
+			p = time_fmt_str(p, end, " overflow x");
+			p = time_fmt_u32(p, end, entry->overflows);
+		}
+		*p++ = '\n';
+
+		queue_send_buff((uint8_t*)msg, p - msg, msg_pool_free, timeout);
+	}
+}
@@ -32,33 +32,12 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 //					Implementation of printf like feature using ARM Cortex M3/M4/ ITM functionality
+//					The output is buffered (itm_out.c) and drained to ITM stimulus port 0 by the idle task
 //					This function will not work for ARM Cortex M0/M0+
 //					If you are using Cortex M0, then you can use semihosting feature of openOCD
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-
-//Debug Exception and Monitor Control Register base address
-#define DEMCR        			*((volatile uint32_t*) 0xE000EDFCU )
-
-/* ITM register addresses */
-#define ITM_STIMULUS_PORT0   	*((volatile uint32_t*) 0xE0000000 )
-#define ITM_TRACE_EN          	*((volatile uint32_t*) 0xE0000E00 )
-
-void ITM_SendChar(uint8_t ch)
-{
-
-	//Enable TRCENA
-	DEMCR |= ( 1 << 24);
-
-	//enable stimulus port 0
-	ITM_TRACE_EN |= ( 1 << 0);
-
-	// read FIFO status in bit [0]:
-	while(!(ITM_STIMULUS_PORT0 & 1));
-
-	//Write to ITM stimulus port0
-	ITM_STIMULUS_PORT0 = ch;
-}
+#include "itm_out.h"
 
 /* Variables */
 extern int __io_putchar(int ch) __attribute__((weak));
@@ -109,13 +88,11 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
-  int DataIdx;
 
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
-  {
-    //__io_putchar(*ptr++);
-    ITM_SendChar(*ptr++);
-  }
+  // Never waits - the text is dropped when the buffer is full
+  //__io_putchar(*ptr++);
+  itm_out_write(ITM_CH_LOG, ptr, len);
+
   return len;
 }
 
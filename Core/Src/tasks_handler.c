@@ -7,314 +7,569 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "main.h"
-
-extern uint32_t leds_execute(char* option);
-extern uint32_t rtc_execute(int option);
+#include "uart_rx.h"
+#include "uart_tx.h"
+#include "cmd_registry.h"
+#include "dlog.h"
+#include "cpu_stats.h"
+#include "stack_mon.h"
+#include "mem_heap.h"
+#include "lp_idle.h"
+#include "clk_profile.h"
+#include "ao.h"
+#include "hsm.h"
+#include "app_hsm.h"
+#include "proto.h"
 
 
 char* error_cmd = "error: invalid input command\n";
+static const char* error_cmd_long = "error: command too long\n";
+
+/* Command pool */
+static command_t cmd_pool[CMD_POOL_SIZE];
+static QueueHandle_t q_cmd_free;	/* Free command slots */
+
+/* Command queue - SRAM */
+static StaticQueue_t q_cmd_free_struct;
+static uint8_t q_cmd_free_storage[CMD_POOL_SIZE * sizeof(command_t*)];
+
+/* Application signals */
+enum{
+	APP_SIG_CMD = AO_SIG_USER,		/* user command - data is the command_t, released by the handler */
+};
+
+/* Active objects - the menus and the console router, run by the AO task (priority order) */
+static ao_t menu_ao;
+static ao_t leds_ao;
+static ao_t rtc_ao;
+static ao_t console_ao;		/* routes the commands to the active object of the current state */
+
+/* Event queues - a command slot each */
+static uint8_t menu_ao_storage[AO_QUEUE_STORAGE(CMD_POOL_SIZE)];
+static uint8_t leds_ao_storage[AO_QUEUE_STORAGE(CMD_POOL_SIZE)];
+static uint8_t rtc_ao_storage[AO_QUEUE_STORAGE(CMD_POOL_SIZE)];
+static uint8_t console_ao_storage[AO_QUEUE_STORAGE(CMD_POOL_SIZE)];
+
+uint32_t cmd_dropped;				/* Commands dropped - pool exhausted */
+uint32_t cmd_overlong;				/* Lines dropped - longer than the command payload */
+
+/* The rest of an overlong line is dropped up to its 'end of message' */
+static uint32_t cmd_skip_line;
 
 /**
- * @brief This task handle the UART messages transmission
- *
- * @param cmd - Pointer to the command struct
- *
- * @return Non zero value if the queue is empty or 'end of message' character is missing
+ * @brief This function creates the command pool
  *
- * @note cmd payload size should be equal or larger than queue size
+ * @note Call before the scheduler starts
  * */
-static int extract_command(command_t* cmd){
-	BaseType_t ret;
-	char item; 		// data byte
-	uint32_t i = 0;
+void cmd_pool_init(void){
+	command_t* cmd;
+	uint32_t i;
 
-	ret = uxQueueMessagesWaiting(q_data);
-	if(ret <= 0){
-		return -1;
+	q_cmd_free = xQueueCreateStatic(CMD_POOL_SIZE, sizeof(command_t*), q_cmd_free_storage, &q_cmd_free_struct);
+	configASSERT(q_cmd_free);
+
+	for(i = 0; i < CMD_POOL_SIZE; i++){
+		cmd = &cmd_pool[i];
+		xQueueSend(q_cmd_free, &cmd, 0);
 	}
+}
 
-	do{
-		// Pull queue data
-		ret = xQueueReceive(q_data, &item, 0);
-		if(ret == pdTRUE){
-			cmd->payload[i++] = item;
-		}
-		else return -1;	/* No more items in the q - no '\n' received - Invalid command */
-	}while(item != '\n');
+/**
+ * @brief This function takes a free command slot
+ *
+ * @return The slot, NULL if the pool is exhausted
+ * */
+command_t* cmd_alloc(void){
+	command_t* cmd = NULL;
 
-	// Handle the end of command string
-	cmd->payload[i-1] = '\0'; // Replace '\n' with '\0';
-	cmd->len = i-1;
+	xQueueReceive(q_cmd_free, &cmd, 0);
 
-	return 0;
+	return cmd;
 }
 
 /**
- * @brief This
+ * @brief This function returns a command slot to the pool
+ * */
+void cmd_release(command_t* cmd){
+	xQueueSend(q_cmd_free, &cmd, 0);
+}
+
+/**
+ * @brief This function extracts a command from the input ring
  *
- * @param
+ * @param cmd - Pointer to the command struct
+ * @param eom - Offset of the 'end of message' character in the ring - shorter than the payload
+ *
+ * @note The command is located in place - only a complete command is copied out of the ring.
+ * */
+static void extract_command(command_t* cmd, uint32_t eom){
+	ring_span_t spans[2];
+	uint32_t len = eom;
+	uint32_t n, i;
+	uint32_t copied = 0;
+
+	n = ring_buff_peek(&uart_rx_ring, len, spans);
+	for(i = 0; i < n; i++){
+		memcpy(&cmd->payload[copied], spans[i].data, spans[i].len);
+		copied += spans[i].len;
+	}
+
+	// Handle the end of command string
+	cmd->payload[len] = '\0';
+	cmd->len = len;
+
+	// Release the command and its '\n'
+	ring_buff_consume(&uart_rx_ring, eom + 1);
+}
+
+/**
+ * @brief This function moves a command from the input ring to a pool slot and posts it
  *
- * @return
+ * @return Non zero value if there is no complete command in the ring
  *
- * @note
+ * @note A binary frame (leading zero byte) goes to the binary protocol (proto_receive()).
+ * @note A partial command (no 'end of message' yet) stays in the ring for the next burst.
+ * 		 The commands are handled in order by the active object of the current state (console_ao).
+ * @note A line longer than the payload is dropped as a whole (no prefix is dispatched) and reported.
  * */
-void process_command(command_t* cmd){
+int process_command(void){
+	ao_event_t e = {APP_SIG_CMD, 0, NULL, 0};
+	command_t* cmd;
+	int32_t eom;
+
+	// Binary frame - detected by its leading delimiter
+	if(proto_frame_start(&uart_rx_ring)){
+		return proto_receive(&uart_rx_ring);
+	}
 
-	BaseType_t ret = extract_command(cmd);
-	if(ret){
-		return;
+	eom = ring_buff_find(&uart_rx_ring, '\n');
+	if(eom < 0){
+		// A full ring without 'end of message' can't become a valid command - drop it up to the next one
+		if(ring_buff_free(&uart_rx_ring) == 0){
+			ring_buff_consume(&uart_rx_ring, ring_buff_count(&uart_rx_ring));
+			if(cmd_skip_line == 0){
+				cmd_skip_line = 1;
+				cmd_overlong++;
+				queue_send_msg(error_cmd_long, 0);
+			}
+		}
+		return -1;
 	}
 
-	switch(app_curr_state){
-	case sMainMenu:
-		xTaskNotify(menu_task_handle, (uint32_t)cmd, eSetValueWithOverwrite);
-		break;
-	case sLedEffect:
-		xTaskNotify(leds_task_handle, (uint32_t)cmd, eSetValueWithOverwrite);
-		break;
-	case sRtcMenu:
-	case sRtcTimeConfig:
-	case sRtcDateConfig:
-	case sRtcReport:
-		xTaskNotify(rtc_task_handle, (uint32_t)cmd, eSetValueWithOverwrite);
-		break;
+	if(cmd_skip_line || (uint32_t)eom >= sizeof(cmd->payload)){
+		// The end (or the whole) of an overlong line
+		ring_buff_consume(&uart_rx_ring, (uint32_t)eom + 1);
+		if(cmd_skip_line == 0){
+			cmd_overlong++;
+			queue_send_msg(error_cmd_long, 0);
+		}
+		cmd_skip_line = 0;
+		return 0;
 	}
 
+	cmd = cmd_alloc();
+	if(cmd == NULL){
+		// Pool exhausted - drop the command
+		ring_buff_consume(&uart_rx_ring, (uint32_t)eom + 1);
+		cmd_dropped++;
+		return 0;
+	}
+
+	extract_command(cmd, (uint32_t)eom);
+
+	// Can't fail - the queue holds all the pool slots
+	e.data = cmd;
+	ao_post(&console_ao, &e);
+
+	return 0;
 }
 
 /**
- * This function receives the USRT messages from the queue
+ * This function receives the USRT messages from the input ring
  *
  *  */
 void command_handle_task_handler(void* params){
-	command_t cmd;
 
 	while(1){
-		// Wait for data
-		if(xTaskNotifyWait(0, 0, NULL, portMAX_DELAY)){
-			process_command(&cmd);
-		}
+		// Wait for data - one notification per received burst, up to the timeout of a partial binary frame
+		xTaskNotifyWait(0, 0, NULL, proto_rx_wait());
+
+		// A burst may hold several commands
+		while(process_command() == 0);
 	}
 }
 
 /**
- * @brief This task handle the UART messages transmission
+ * @brief This function pushes a message buffer to the print queue
  *
- * @return void
+ * @param msg		Message buffer
+ * @param len		Message length
+ * @param release	Called once the message was transmitted, NULL if the buffer is never released
+ * @param timeout	Max time to wait for a free queue slot
+ *
+ * @return pdTRUE if the message was queued
+ *
+ * @note The ownership of the buffer moves to the print task - on failure the buffer is released here
  * */
-void print_task_handler(void* params){
-	uint32_t msg; // buffer
+BaseType_t queue_send_buff(const uint8_t* msg, uint32_t len, tx_release_t release, TickType_t timeout){
+	tx_command_t tx_msg = {msg, len, release};
+	BaseType_t ret;
 
-	while(1){
-		// receive item from the queue
-		if(xQueueReceive(q_print, (void*)&msg, portMAX_DELAY))
-		{
-			HAL_UART_Transmit(&huart2, (uint8_t*)msg, strlen((char*)msg), HAL_MAX_DELAY);
-		}
+	ret = xQueueSend(q_print, &tx_msg, timeout);
+	if(ret != pdTRUE && release){
+		release((void*)msg);
 	}
+
+	return ret;
 }
 
 /**
- * @brief This
+ * @brief This function pushes a constant string to the print queue
  *
- * @param
+ * @param message	Null terminated string that stays valid (not released)
+ * @param timeout	Max time to wait for a free queue slot
  *
- * @return
+ * @return pdTRUE if the message was queued
+ * */
+BaseType_t queue_send_msg(const char* message, TickType_t timeout){
+	return queue_send_buff((const uint8_t*)message, strlen(message), NULL, timeout);
+}
+
+/**
+ * @brief This task handle the UART messages transmission
  *
- * @note
+ * @return void
+ *
+ * @note All the queued messages are coalesced into the DMA buffers and sent together
  * */
-void menu_task_handler(void* params){
-	BaseType_t status;
-	command_t* rx_cmd;
-	uint32_t cmd_value;
-	int option = -1;
-
-	char* menu_msg =  "\n=====================\n"
-						"|\tMENU\t\t|\n"
-					    "=====================\n"
-					    "LED effect\t--> 0\n"
-					    "Date and time\t--> 1\n"
-					    "Exit\t\t--> 2\n"
-					    "Enter your choice here: ";
+void print_task_handler(void* params){
+	tx_command_t tx_msg;
+	uint32_t depth;
 
 	while(1){
-		// Add the menu start message to the TX queue
-		xQueueSend(q_print, &menu_msg, portMAX_DELAY);
-
-		// Wait for the user command
-		xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
-
-		rx_cmd = (command_t*)cmd_value;
-
-		if(rx_cmd->len == 1){
-			option = atoi((char*)&rx_cmd->payload[0]);
-
-			switch(option){
-				case 0: // LEDs functions
-					app_curr_state = sLedEffect;
-					status = xTaskNotify(leds_task_handle, 0, eNoAction);
-					configASSERT(status == pdPASS);
-					break;
+		// receive item from the queue
+		if(xQueueReceive(q_print, (void*)&tx_msg, portMAX_DELAY))
+		{
+			depth = uxQueueMessagesWaiting(q_print) + 1;
+			if(depth > uart_tx_stats.q_depth_max){
+				uart_tx_stats.q_depth_max = depth;
+			}
 
-				case 1: // Date and time
-					app_curr_state = sRtcMenu;
-					status = xTaskNotify(rtc_task_handle, 0, eNoAction);
-					configASSERT(status == pdPASS);
-					break;
+			// Gather the rest of the queued messages
+			do{
+				uart_tx_write(tx_msg.msg, tx_msg.len);
 
-				case 2:	//Exit
-					printf("deleting menu task\n");
-					/* options: delete All tasks, deinit uart*/
-					break;
+				// The message was copied to the DMA buffer - give the buffer back
+				if(tx_msg.release){
+					tx_msg.release((void*)tx_msg.msg);
+				}
+			}while(xQueueReceive(q_print, (void*)&tx_msg, 0));
 
-				default:
-					break;
-			}
-		}
-		else{
-			// Invalid input
-			xQueueSend(q_print, &error_cmd, portMAX_DELAY);
-			continue;
+			uart_tx_flush();
 		}
-
-		// Wait for the user command to start menu again
-		status = xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
-		configASSERT(status == pdPASS);
 	}
-
 }
 
+/* Main menu handlers result */
+#define MENU_RET_IDLE		0	/* wait for any input to show the menu again */
+#define MENU_RET_SUBMENU	1	/* the sub menu took over */
+#define MENU_RET_SHOW		2	/* show the menu again */
+
 /**
- * @brief This
+ * @brief This function starts a sub menu
  *
- * @param
+ * @param event the sub menu event (evLeds, evRtc)
  *
- * @return
+ * @return MENU_RET_SUBMENU - the sub menu active object takes the console
+ * */
+static uint32_t menu_start(uint32_t event, const arg_val_t* args){
+	app_event((app_event_t)event);
+	return MENU_RET_SUBMENU;
+}
+
+/**
+ * @brief This function handles the menu exit option
  *
- * @note
+ * @return MENU_RET_IDLE - no sub menu was started
  * */
-void leds_task_handler(void* params){
-	uint32_t ret;
-	command_t* rx_cmd;
-	tx_command_t tx_msg;
-	(void)tx_msg;
-	uint32_t cmd_value;
-	char option[5];
+static uint32_t menu_exit(uint32_t param, const arg_val_t* args){
+	DLOG("menu: idle until the next input\n");
+	return MENU_RET_IDLE;
+}
+
+/**
+ * @brief This function prints the tasks CPU usage
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_stats(uint32_t param, const arg_val_t* args){
+	cpu_stats_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
-	char* led_msg = "=====================\n"
-					"|\tLEDs\t\t|\n"
-				    "=====================\n"
-				    "Options: exit, e1, e2, e3, e4\n"
-				    "Enter your choice here: ";
+/**
+ * @brief This function prints the tasks stack usage
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_stack(uint32_t param, const arg_val_t* args){
+	stack_mon_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
+/**
+ * @brief This function prints the heap regions usage
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_heap(uint32_t param, const arg_val_t* args){
+	mem_heap_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
-	while(1){
+/**
+ * @brief This function prints the active objects event latency
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_ao_stats(uint32_t param, const arg_val_t* args){
+	ao_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
-		// Wait for the user command to activate LEDS
-		xTaskNotifyWait(0, 0, NULL, portMAX_DELAY); //Go Blocking state till Notification arrive
+/**
+ * @brief This function prints the sleep residency and the wake latency
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_power(uint32_t param, const arg_val_t* args){
+	lp_idle_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
-		while(1){
-			// Print led_msg
-			xQueueSend(q_print, &led_msg, portMAX_DELAY);
+/* Clock command schema - clock <profile> or clock show */
+static const char* const menu_clock_options[] = {"perf", "balanced", "low", "show", NULL};	/* clk_profile_t */
+static const arg_spec_t menu_clock_args = {ARG_ENUM, 0, 0, menu_clock_options};
 
-			// Wait for the user command
-			xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
+/**
+ * @brief This function switches the clock profile and prints the clocks
+ *
+ * @return MENU_RET_SHOW
+ * */
+static uint32_t menu_clock(uint32_t param, const arg_val_t* args){
 
-			rx_cmd = (command_t*)cmd_value;
+	if(args[0].idx < CLK_PROFILE_NUM && clk_profile_set((clk_profile_t)args[0].idx) != HAL_OK){
+		queue_send_msg("error: clock profile did not start\n", portMAX_DELAY);
+	}
 
-			if(rx_cmd->len <= 4){
-				// Get option
-				strncpy(option, (char*)rx_cmd->payload, sizeof(option));
-			}
-			else{
-				// Invalid input
-				xQueueSend(q_print, &error_cmd, 0);
-				continue;
-			}
+	clk_profile_report(portMAX_DELAY);
+	return MENU_RET_SHOW;
+}
 
-			// Execute LEDs function
-			ret = leds_execute(option);
-			if(ret){
-				break;
-			}
-		}
+/**
+ * @brief This function reports a cmd_dispatch() error to the console
+ *
+ * @param ret		cmd_dispatch() negative result
+ * @param timeout	Queue send timeout
+ * */
+static void cmd_error_report(int32_t ret, TickType_t timeout){
 
+	if(CMD_IS_ERR_ARGS(ret)){
+		queue_send_msg(args_err_msg(CMD_ARGS_ERR(ret)), timeout);
+	}
+	else{
+		queue_send_msg(error_cmd, timeout);
 	}
 }
 
+/* Main menu commands */
+const cmd_entry_t menu_cmds[] = {
+	{CMD_GROUP_MENU, "0", 0, NULL, menu_start, evLeds},		/* LEDs functions */
+	{CMD_GROUP_MENU, "1", 0, NULL, menu_start, evRtc},		/* Date and time */
+	{CMD_GROUP_MENU, "2", 0, NULL, menu_exit,  0},			/* Exit */
+	{CMD_GROUP_MENU, "stats", 0, NULL, menu_stats, 0},		/* CPU usage */
+	{CMD_GROUP_MENU, "stack", 0, NULL, menu_stack, 0},		/* Stack usage */
+	{CMD_GROUP_MENU, "heap", 0, NULL, menu_heap, 0},			/* Heap usage */
+	{CMD_GROUP_MENU, "power", 0, NULL, menu_power, 0},		/* Sleep residency */
+	{CMD_GROUP_MENU, "clock", 1, &menu_clock_args, menu_clock, 0},	/* Clock profile */
+	{CMD_GROUP_MENU, "ao", 0, NULL, menu_ao_stats, 0},		/* Event latency */
+	{0}
+};
+
+
+/* Console state machine - used by the dispatcher task only */
+static hsm_t app_hsm;
+static uint8_t app_hsm_table[HSM_TABLE_SIZE(sNum, evNum)];
+
+/* The active object that owns the console in each state */
+static ao_t* const app_state_owner[sNum] = {
+	[sMainMenu]      = &menu_ao,
+	[sMainIdle]      = &menu_ao,
+	[sLedEffect]     = &leds_ao,
+	[sRtcMenu]       = &rtc_ao,
+	[sRtcTimeConfig] = &rtc_ao,
+	[sRtcDateConfig] = &rtc_ao,
+	[sRtcReport]     = &rtc_ao,
+};
+
+/**
+ * @brief This function returns the current console state
+ * */
+state_t app_state(void){
+	return (state_t)hsm_state(&app_hsm);
+}
+
 /**
- * @brief This function is the RTC task handler
+ * @brief This function dispatches a console event - the exit and entry actions run before it returns
  *
- * @param parameters
+ * @param event The event
  *
- * @return	void
+ * @note Called by the handlers (dispatcher task). The event must be handled by the current state.
  * */
-void rtc_task_handler(void* params){
-	uint32_t ret;
-	int option;
+void app_event(app_event_t event){
+	uint32_t taken;
 
-	tx_command_t tx_msg;
-	(void)tx_msg;
+	taken = hsm_dispatch(&app_hsm, event);
+	configASSERT(taken);
+}
 
-	RTC_TimeTypeDef stime;
-	RTC_DateTypeDef sdate;
-	HAL_StatusTypeDef status;
+/**
+ * @brief This function is the console router - passes each command to the active object of the current state
+ *
+ * @note The lowest priority object: a command is routed once the events ahead of it are handled,
+ * 		 so a state change made by the previous command is already in place.
+ * */
+static void console_ao_handler(ao_t* me, const ao_event_t* e){
 
-	uint32_t cmd_value;
-	command_t* rx_cmd;
+	if(e->sig != APP_SIG_CMD){
+		return;
+	}
 
-	const char* rtc_hdr_msg =  "=====================\n"
-						  	   "|\tRTC\t\t|\n"
-						  	   "=====================\n";
+	if(ao_post(app_state_owner[app_state()], e) != pdTRUE){
+		cmd_release((command_t*)e->data);
+		cmd_dropped++;
+	}
+}
 
-	const char* rtc_menu_msg = "Configure time\t\t--> 0\n"
-						       "Configure date\t\t--> 1\n"
-							   "Enable reporting\t--> 2\n"
-							   "Exit\t\t\t--> 3\n"
-							   "Debug\t\t\t--> 4\n"
-							   "Enter your choice here: ";
+/**
+ * @brief This function is the main menu event handler
+ * */
+static void menu_ao_handler(ao_t* me, const ao_event_t* e){
+	command_t* rx_cmd = (command_t*)e->data;
+	int32_t ret;
+
+	if(app_state() == sMainIdle){
+		// Any input starts the menu again
+		cmd_release(rx_cmd);
+		app_event(evDone);
+		return;
+	}
 
-	// Get the time
-	status = HAL_RTC_GetTime(&hrtc, &stime, RTC_FORMAT_BIN);
-	configASSERT(status == HAL_OK);
+	ret = cmd_dispatch(CMD_GROUP_MENU, rx_cmd->payload, rx_cmd->len);
+	cmd_release(rx_cmd);
 
-	// Get the date
-	status = HAL_RTC_GetDate(&hrtc, &sdate, RTC_FORMAT_BIN);
-	configASSERT(status == HAL_OK);
+	if(ret < 0){
+		// Invalid input
+		cmd_error_report(ret, portMAX_DELAY);
+		ret = MENU_RET_SHOW;
+	}
 
-	while(1){
+	if(ret == MENU_RET_SHOW){
+		app_event(evDone);
+	}
+	else if(ret == MENU_RET_IDLE){
+		// Wait for the user command to start menu again
+		app_event(evIdle);
+	}
+	// MENU_RET_SUBMENU - the sub menu shows its own prompt
+}
 
-		// Wait for the user command
-		xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
+/**
+ * @brief This function is the LEDs menu event handler
+ * */
+static void leds_ao_handler(ao_t* me, const ao_event_t* e){
+	command_t* rx_cmd = (command_t*)e->data;
+	int32_t ret;
+
+	// Execute LEDs function
+	ret = cmd_dispatch(CMD_GROUP_LEDS, rx_cmd->payload, rx_cmd->len);
+	cmd_release(rx_cmd);
+
+	if(ret < 0){
+		// Invalid input
+		cmd_error_report(ret, 0);
+		ret = 0;
+	}
 
-		while(1){
+	if(ret == 0){
+		// Not a transition - the effect keeps running
+		leds_entry();
+	}
+	// Non zero - back to Main Menu (leds_exit)
+}
 
-			xQueueSend(q_print, &rtc_hdr_msg, portMAX_DELAY);
-			//rtc_q_print_time_n_date();
-			xQueueSend(q_print, &rtc_menu_msg, portMAX_DELAY);
+/**
+ * @brief This function is the RTC menu event handler
+ *
+ * @note The value prompts of the RTC options (time, date, report) are answered through rtc_input()
+ * */
+static void rtc_ao_handler(ao_t* me, const ao_event_t* e){
+	command_t* rx_cmd = (command_t*)e->data;
+	int32_t ret;
+
+	if(app_state() == sRtcMenu){
+		// Execute command
+		ret = cmd_dispatch(CMD_GROUP_RTC, rx_cmd->payload, rx_cmd->len);
+		if(ret < 0){
+			// Invalid input
+			cmd_error_report(ret, 0);
+			ret = RTC_RET_MENU;
+		}
+	}
+	else{
+		// A value of the current configuration
+		ret = (int32_t)rtc_input(rx_cmd->payload, rx_cmd->len);
+	}
 
-			// Wait for the user choice
-			xTaskNotifyWait(0, 0, &cmd_value, portMAX_DELAY);
+	cmd_release(rx_cmd);
 
-			rx_cmd = (command_t*)cmd_value;
+	if(ret == RTC_RET_MENU){
+		app_event(evDone);
+	}
+	// RTC_RET_EXIT - back to Main Menu, RTC_RET_PROMPT - waits for the value
+}
 
-			if(rx_cmd->len == 1){
-				option = atoi((char*)&rx_cmd->payload[0]);
-			}
-			else{
-				// Invalid input
-				xQueueSend(q_print, &error_cmd, 0);
-				continue;
-			}
+/**
+ * @brief This function creates the active objects of the console
+ *
+ * @note Call after cmd_pool_init() and before the scheduler starts
+ * */
+void app_ao_init(void){
+	hsm_err_t err;
+
+	// Every state and event pair of the console tables is checked once
+	err = hsm_init(&app_hsm, &app_hsm_def, app_hsm_table);
+	configASSERT(err == HSM_OK);
+
+	// Priority order - the binary requests, the menus, the router last
+	proto_init();
+	ao_start(&menu_ao, "Menu", menu_ao_handler, menu_ao_storage, CMD_POOL_SIZE);
+	ao_start(&leds_ao, "LEDS", leds_ao_handler, leds_ao_storage, CMD_POOL_SIZE);
+	ao_start(&rtc_ao, "RTC", rtc_ao_handler, rtc_ao_storage, CMD_POOL_SIZE);
+	ao_start(&console_ao, "Console", console_ao_handler, console_ao_storage, CMD_POOL_SIZE);
+}
 
-			// Execute command
-			ret = rtc_execute(option);
-			if(ret){
-				break;
-			}
+/**
+ * @brief This function is the active objects task handler
+ *
+ * @param parameters
+ *
+ * @return	void
+ * */
+void ao_task_handler(void* params){
 
-		}
-	}
+	// Show the main menu
+	hsm_start(&app_hsm);
 
+	ao_run();
 }
-
@@ -0,0 +1,233 @@
+/*
+ * time_fmt.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <string.h>
+#include "time_fmt.h"
+#include "epoch.h"
+
+/*
+ * Field formatters for the time, date and report messages - a sprintf replacement.
+ * Each function writes its field at p and returns the end of the field (not null terminated),
+ * the caller builds the message and gets the length as end - buffer. Nothing is written at or after
+ * end: a field that does not fit is truncated and the returned pointer stays at end, so the following
+ * fields are dropped as well.
+ */
+
+/* Two digits of 00 - 99 */
+static const char time_fmt_digits[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/* RTC weekday names - RTC_WEEKDAY_MONDAY (1) to RTC_WEEKDAY_SUNDAY (7) */
+static const char time_fmt_weekdays[8][TIME_FMT_WEEKDAY_MAX] = {
+	{'?','?','?'}, {'M','o','n'}, {'T','u','e'}, {'W','e','d'}, {'T','h','u'}, {'F','r','i'}, {'S','a','t'}, {'S','u','n'}
+};
+
+/**
+ * @brief This function copies a field that was formatted in a temporary buffer, truncated at end
+ * */
+static char* time_fmt_copy(char* p, const char* end, const char* src, uint32_t len){
+
+	if(len > (uint32_t)(end - p)){
+		len = end - p;
+	}
+	memcpy(p, src, len);
+
+	return p + len;
+}
+
+/**
+ * @brief This function writes the two digits of 00 - 99 (no bound check)
+ * */
+static char* time_fmt_put2(char* p, uint32_t value){
+	const char* d = &time_fmt_digits[value * 2];
+
+	p[0] = d[0];
+	p[1] = d[1];
+
+	return p + 2;
+}
+
+/**
+ * @brief This function writes the digits of a decimal number at the end of tmp (no bound check)
+ *
+ * @return The first digit
+ * */
+static char* time_fmt_digits_u32(char* t, uint32_t value){
+	uint32_t q;
+
+	// Two digits per step from the end
+	while(value >= 100){
+		q = value / 100;
+		t -= 2;
+		time_fmt_put2(t, value - q * 100);
+		value = q;
+	}
+
+	if(value >= 10){
+		t -= 2;
+		time_fmt_put2(t, value);
+	}
+	else{
+		*--t = '0' + value;
+	}
+
+	return t;
+}
+
+/**
+ * @brief This function copies a null terminated string
+ * */
+char* time_fmt_str(char* p, const char* end, const char* str){
+
+	while(*str && p < end){
+		*p++ = *str++;
+	}
+
+	return p;
+}
+
+/**
+ * @brief This function writes a character
+ * */
+char* time_fmt_chr(char* p, const char* end, char c){
+
+	if(p < end){
+		*p++ = c;
+	}
+
+	return p;
+}
+
+/**
+ * @brief This function writes a two digits number (00 - 99)
+ * */
+char* time_fmt_u2(char* p, const char* end, uint32_t value){
+	char tmp[2];
+
+	if(end - p >= 2){
+		return time_fmt_put2(p, value);
+	}
+
+	time_fmt_put2(tmp, value);
+
+	return time_fmt_copy(p, end, tmp, 2);
+}
+
+/**
+ * @brief This function writes a zero padded decimal number
+ *
+ * @param width Minimum number of digits (up to TIME_FMT_U32_MAX)
+ * */
+char* time_fmt_u32_pad(char* p, const char* end, uint32_t value, uint32_t width){
+	char tmp[TIME_FMT_U32_MAX];
+	char* t;
+	uint32_t len;
+
+	t = time_fmt_digits_u32(&tmp[TIME_FMT_U32_MAX], value);
+	len = &tmp[TIME_FMT_U32_MAX] - t;
+
+	while(len < width && p < end){
+		*p++ = '0';
+		width--;
+	}
+
+	return time_fmt_copy(p, end, t, len);
+}
+
+/**
+ * @brief This function writes a decimal number
+ * */
+char* time_fmt_u32(char* p, const char* end, uint32_t value){
+	return time_fmt_u32_pad(p, end, value, 1);
+}
+
+/**
+ * @brief This function writes a decimal number right aligned in a column
+ *
+ * @param width Column width - padded with spaces
+ * */
+char* time_fmt_u32_align(char* p, const char* end, uint32_t value, uint32_t width){
+	char tmp[TIME_FMT_U32_MAX];
+	char* t;
+	uint32_t len;
+
+	t = time_fmt_digits_u32(&tmp[TIME_FMT_U32_MAX], value);
+	len = &tmp[TIME_FMT_U32_MAX] - t;
+
+	while(len < width && p < end){
+		*p++ = ' ';
+		width--;
+	}
+
+	return time_fmt_copy(p, end, t, len);
+}
+
+/**
+ * @brief This function writes the time - HH:MM:SS, followed by " [AM]"/" [PM]" in 12 hours format
+ *
+ * @param hour_format RTC_HOURFORMAT_12 or RTC_HOURFORMAT_24 (hrtc.Init.HourFormat)
+ * */
+char* time_fmt_time(char* p, const char* end, const RTC_TimeTypeDef* sTime, uint32_t hour_format){
+	char tmp[TIME_FMT_TIME_MAX];
+	char* t = tmp;
+
+	t = time_fmt_put2(t, sTime->Hours);
+	*t++ = ':';
+	t = time_fmt_put2(t, sTime->Minutes);
+	*t++ = ':';
+	t = time_fmt_put2(t, sTime->Seconds);
+
+	if(hour_format == RTC_HOURFORMAT_12){
+		t[0] = ' ';
+		t[1] = '[';
+		t[2] = sTime->TimeFormat == RTC_HOURFORMAT12_AM ? 'A' : 'P';
+		t[3] = 'M';
+		t[4] = ']';
+		t += 5;
+	}
+
+	return time_fmt_copy(p, end, tmp, t - tmp);
+}
+
+/**
+ * @brief This function writes the date - DD-MM-YYYY
+ * */
+char* time_fmt_date(char* p, const char* end, const RTC_DateTypeDef* sDate){
+	char tmp[TIME_FMT_DATE_MAX];
+	char* t = tmp;
+
+	t = time_fmt_put2(t, sDate->Date);
+	*t++ = '-';
+	t = time_fmt_put2(t, sDate->Month);
+	*t++ = '-';
+	t = time_fmt_put2(t, EPOCH_RTC_YEAR_BASE / 100);
+	t = time_fmt_put2(t, sDate->Year);
+
+	return time_fmt_copy(p, end, tmp, t - tmp);
+}
+
+/**
+ * @brief This function writes the weekday name - Mon to Sun
+ *
+ * @param weekday RTC weekday (RTC_WEEKDAY_MONDAY - RTC_WEEKDAY_SUNDAY)
+ * */
+char* time_fmt_weekday(char* p, const char* end, uint32_t weekday){
+
+	if(weekday > RTC_WEEKDAY_SUNDAY){
+		weekday = 0;
+	}
+
+	return time_fmt_copy(p, end, time_fmt_weekdays[weekday], TIME_FMT_WEEKDAY_MAX);
+}
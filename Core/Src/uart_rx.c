@@ -0,0 +1,162 @@
+/*
+ * uart_rx.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "proto.h"
+#include "uart_rx.h"
+
+/* DMA circular reception buffer */
+static uint8_t uart_rx_dma_buff[UART_RX_DMA_BUFF_SIZE];
+
+/* Index of the first byte in the DMA buffer that was not delivered yet */
+static uint32_t uart_rx_tail;
+
+/* Input ring storage */
+static uint8_t uart_rx_ring_buff[UART_RX_RING_SIZE];
+ring_buff_t uart_rx_ring;
+
+uart_rx_stats_t uart_rx_stats;
+
+volatile TickType_t uart_rx_last_tick;
+
+/**
+ * @brief This function splits the new data of a circular buffer to contiguous spans
+ *
+ * @param tail	Pointer to the index of the first undelivered byte, advanced to head
+ * @param head	Current write position of the DMA (0 - size)
+ * @param buff	The circular buffer
+ * @param size	The circular buffer size
+ * @param spans	Output spans (at most two when the data wraps around)
+ *
+ * @return Number of valid spans (0 - 2)
+ * */
+uint32_t uart_rx_spans(uint32_t* tail, uint32_t head, const uint8_t* buff, uint32_t size, uart_rx_span_t spans[2]){
+	uint32_t n = 0;
+	uint32_t start = *tail;
+
+	// DMA position equals to size at transfer complete - same as 0
+	if(head >= size){
+		head = 0;
+	}
+
+	if(head > start){
+		spans[n].data = &buff[start];
+		spans[n++].len = head - start;
+	}
+	else if(head < start){
+		// Wrap around: the buffer end first, then the buffer start
+		spans[n].data = &buff[start];
+		spans[n++].len = size - start;
+
+		if(head){
+			spans[n].data = &buff[0];
+			spans[n++].len = head;
+		}
+	}
+
+	*tail = head;
+
+	return n;
+}
+
+/**
+ * @brief This function pushes a received chunk to the input ring
+ *
+ * @param span Received data
+ *
+ * @return pdTRUE if the chunk holds an 'end of message' character, a frame delimiter or the ring is full
+ * */
+static BaseType_t uart_rx_deliver(const uart_rx_span_t* span){
+	uint32_t len;
+
+	len = ring_buff_write(&uart_rx_ring, span->data, span->len);
+	if(len < span->len){
+		uart_rx_stats.dropped += span->len - len;
+		return pdTRUE;
+	}
+
+	// A frame ends with its delimiter (PROTO_DELIM) - it has no 'end of message'
+	return memchr(span->data, '\n', span->len) != NULL || memchr(span->data, PROTO_DELIM, span->len) != NULL;
+}
+
+/**
+ * @brief This function starts the circular DMA reception at the DMA buffer start
+ *
+ * @note The input ring is not touched - the command task may be reading it
+ * */
+static HAL_StatusTypeDef uart_rx_dma_start(UART_HandleTypeDef* huart){
+	uart_rx_tail = 0;
+
+	return HAL_UARTEx_ReceiveToIdle_DMA(huart, uart_rx_dma_buff, sizeof(uart_rx_dma_buff));
+}
+
+/**
+ * @brief This function initializes the input ring and starts the circular DMA reception with idle line detection
+ *
+ * @param huart UART handle
+ *
+ * @return HAL status
+ *
+ * @note Called once at boot, before the scheduler starts
+ * */
+HAL_StatusTypeDef uart_rx_start(UART_HandleTypeDef* huart){
+	ring_buff_init(&uart_rx_ring, uart_rx_ring_buff, sizeof(uart_rx_ring_buff));
+
+	return uart_rx_dma_start(huart);
+}
+
+/**
+  * @brief  Reception Event Callback (Rx event notification called after use of advanced reception service).
+  * Called on DMA half transfer, DMA transfer complete and idle line. The new data is pushed to the input
+  * ring as one burst and the command handling task is notified once per burst.
+  * @param  huart UART handle
+  * @param  Size  Current DMA position in the reception buffer
+  * @retval None
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){
+	uart_rx_span_t spans[2];
+	uint32_t n, i;
+	BaseType_t notify = pdFALSE;
+	BaseType_t woken = pdFALSE;
+
+	if(huart->Instance == USART2){
+		n = uart_rx_spans(&uart_rx_tail, Size, uart_rx_dma_buff, sizeof(uart_rx_dma_buff), spans);
+		if(n == 0){
+			return;
+		}
+
+		for(i = 0; i < n; i++){
+			notify |= uart_rx_deliver(&spans[i]);
+			uart_rx_stats.bytes += spans[i].len;
+		}
+		uart_rx_stats.bursts++;
+		uart_rx_last_tick = xTaskGetTickCountFromISR();
+
+		// One notification per burst
+		if(notify){
+			xTaskNotifyFromISR(cmd_handler_task_handle, 0, eNoAction, &woken);
+			portYIELD_FROM_ISR(woken);
+		}
+	}
+}
+
+/**
+  * @brief  UART error callback.
+  * The HAL aborts the DMA reception on error - restart it. The input ring keeps its data: it belongs to
+  * the command task (single consumer), only the DMA buffer position is resynchronized.
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart){
+
+	if(huart->Instance == USART2){
+		uart_rx_stats.errors++;
+
+		if(huart->RxState == HAL_UART_STATE_READY){
+			uart_rx_dma_start(huart);
+		}
+	}
+}
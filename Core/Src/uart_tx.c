@@ -0,0 +1,128 @@
+/*
+ * uart_tx.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "uart_tx.h"
+
+/*
+ * Double buffered DMA transmission.
+ * The print task fills one buffer while the DMA sends the other one, and blocks
+ * only when both are in use. Must be called from the print task only.
+ */
+static uint8_t uart_tx_dma_buff[2][UART_TX_BUFF_SIZE];
+static uint32_t uart_tx_fill_idx;		/* buffer being filled */
+static uint32_t uart_tx_fill_len;		/* bytes in the buffer being filled */
+static uint32_t uart_tx_in_flight;		/* a DMA transfer was started and not yet waited for */
+static TickType_t uart_tx_start_tick;
+
+uart_tx_stats_t uart_tx_stats;
+
+/**
+ * @brief This function waits for the DMA transfer in flight to complete
+ *
+ * @note The CPU is released while the bytes are on the wire
+ * */
+static void uart_tx_wait(void){
+
+	if(!uart_tx_in_flight){
+		return;
+	}
+
+	if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UART_TX_TIMEOUT_MS)) == 0){
+		// Transfer got stuck - abort it
+		HAL_UART_AbortTransmit(&huart2);
+		uart_tx_stats.errors++;
+
+		// A completion that raced the abort would end the next wait early
+		ulTaskNotifyTake(pdTRUE, 0);
+	}
+
+	uart_tx_in_flight = 0;
+}
+
+/**
+ * @brief This function starts the transmission of the buffer being filled and swaps the buffers
+ * */
+void uart_tx_flush(void){
+	HAL_StatusTypeDef status;
+
+	if(uart_tx_fill_len == 0){
+		return;
+	}
+
+	// Only one transfer at a time - the other buffer must be sent first
+	uart_tx_wait();
+
+	uart_tx_start_tick = xTaskGetTickCount();
+	status = HAL_UART_Transmit_DMA(&huart2, uart_tx_dma_buff[uart_tx_fill_idx], uart_tx_fill_len);
+	if(status == HAL_BUSY){
+		// The line is still busy - wait for (or abort) that transfer once and retry
+		uart_tx_in_flight = 1;
+		uart_tx_wait();
+
+		uart_tx_start_tick = xTaskGetTickCount();
+		status = HAL_UART_Transmit_DMA(&huart2, uart_tx_dma_buff[uart_tx_fill_idx], uart_tx_fill_len);
+	}
+
+	if(status == HAL_OK){
+		uart_tx_in_flight = 1;
+		uart_tx_stats.bytes += uart_tx_fill_len;
+		uart_tx_stats.transfers++;
+	}
+	else{
+		uart_tx_stats.errors++;
+		uart_tx_stats.dropped += uart_tx_fill_len;
+	}
+
+	uart_tx_fill_idx ^= 1;
+	uart_tx_fill_len = 0;
+}
+
+/**
+ * @brief This function appends a message to the transmission buffer
+ *
+ * @param data	Message
+ * @param len	Message length
+ *
+ * @note The buffer is sent when full or by uart_tx_flush()
+ * */
+void uart_tx_write(const uint8_t* data, uint32_t len){
+	uint32_t chunk;
+
+	uart_tx_stats.messages++;
+
+	while(len){
+		chunk = UART_TX_BUFF_SIZE - uart_tx_fill_len;
+		if(chunk > len){
+			chunk = len;
+		}
+
+		memcpy(&uart_tx_dma_buff[uart_tx_fill_idx][uart_tx_fill_len], data, chunk);
+		uart_tx_fill_len += chunk;
+		data += chunk;
+		len -= chunk;
+
+		if(uart_tx_fill_len == UART_TX_BUFF_SIZE){
+			uart_tx_flush();
+		}
+	}
+}
+
+/**
+  * @brief  Tx Transfer completed callback (UART TC interrupt after the last DMA byte).
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart){
+	BaseType_t woken = pdFALSE;
+
+	if(huart->Instance == USART2){
+		uart_tx_stats.busy_ticks += xTaskGetTickCountFromISR() - uart_tx_start_tick;
+
+		vTaskNotifyGiveFromISR(print_task_handle, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
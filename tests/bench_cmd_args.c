@@ -0,0 +1,123 @@
+/*
+ * bench_cmd_args.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "cmd_args.h"
+#include "host.h"
+
+/*
+ * args_parse() time per command line against sscanf() with the same checks (range, keyword, extra
+ * argument). The lines are the arguments of the console commands.
+ */
+
+#define RUNS		2000000
+
+static const char* const profiles[] = {"perf", "balanced", "low", "show", NULL};
+
+static const arg_spec_t int_spec[] = {{ARG_INT, 1, 86400, NULL}};
+static const arg_spec_t enum_spec[] = {{ARG_ENUM, 0, 0, profiles}};
+static const arg_spec_t sub_spec[] = {{ARG_INT, 1, 86400, NULL}, {ARG_STR, 0, 0, NULL}};
+static const arg_spec_t four_spec[] = {
+	{ARG_INT, 2000, 2099, NULL}, {ARG_INT, 1, 12, NULL}, {ARG_INT, 1, 31, NULL}, {ARG_INT, 0, 23, NULL}
+};
+
+typedef struct{
+	const char* name;
+	const char* line;
+	const arg_spec_t* spec;
+	uint32_t nspec;
+}bench_case_t;
+
+static const bench_case_t cases[] = {
+	{"int", " 3600", int_spec, 1},
+	{"enum", " balanced", enum_spec, 1},
+	{"int str", " 60 status", sub_spec, 2},
+	{"4 ints", " 2026 10 17 12", four_spec, 4},
+};
+
+/**
+ * @brief This function parses a line with sscanf() by the same schema
+ * */
+static int scanf_parse(const bench_case_t* c, arg_val_t* out){
+	char str[16];
+	char extra[2];
+	int v[4];
+	uint32_t k;
+
+	switch(c - cases){
+		case 0:
+			if(sscanf(c->line, "%d %1s", &v[0], extra) != 1 || v[0] < 1 || v[0] > 86400){
+				return -1;
+			}
+			out[0].num = v[0];
+			return 0;
+		case 1:
+			if(sscanf(c->line, "%15s %1s", str, extra) != 1){
+				return -1;
+			}
+			for(k = 0; profiles[k]; k++){
+				if(strcasecmp(profiles[k], str) == 0){
+					out[0].idx = k;
+					return 0;
+				}
+			}
+			return -1;
+		case 2:
+			if(sscanf(c->line, "%d %15s %1s", &v[0], str, extra) != 2 || v[0] < 1 || v[0] > 86400){
+				return -1;
+			}
+			out[0].num = v[0];
+			out[1].str.len = strlen(str);
+			return 0;
+		default:
+			if(sscanf(c->line, "%d %d %d %d %1s", &v[0], &v[1], &v[2], &v[3], extra) != 4 ||
+					v[0] < 2000 || v[0] > 2099 || v[1] < 1 || v[1] > 12 || v[2] < 1 || v[2] > 31 ||
+					v[3] < 0 || v[3] > 23){
+				return -1;
+			}
+			out[0].num = v[0];
+			return 0;
+	}
+}
+
+int main(void){
+	const bench_case_t* c;
+	arg_val_t out[CMD_MAX_ARGS];
+	uint64_t start, args_ns, scanf_ns;
+	uint32_t i, len;
+	int ret;
+
+	printf("cmd_args: ns per line (%u runs)\n", RUNS);
+
+	for(c = cases; c < &cases[sizeof(cases) / sizeof(cases[0])]; c++){
+		len = strlen(c->line);
+
+		start = host_ns();
+		for(i = 0; i < RUNS; i++){
+			HOST_KEEP(c->line);
+			ret = args_parse(c->line, len, c->spec, c->nspec, out, NULL);
+			HOST_KEEP(ret);
+		}
+		args_ns = host_ns() - start;
+		CHECK(ret == ARGS_OK);
+
+		start = host_ns();
+		for(i = 0; i < RUNS; i++){
+			HOST_KEEP(c->line);
+			ret = scanf_parse(c, out);
+			HOST_KEEP(ret);
+		}
+		scanf_ns = host_ns() - start;
+		CHECK(ret == 0);
+
+		printf("  %-8s args_parse %6.1f  sscanf %6.1f  (%.1fx)\n", c->name, (double)args_ns / RUNS,
+				(double)scanf_ns / RUNS, (double)scanf_ns / args_ns);
+	}
+
+	return host_result("cmd_args bench");
+}
@@ -0,0 +1,193 @@
+/*
+ * bench_mem_heap.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mem_heap.h"
+#include "host.h"
+
+/*
+ * Heap stress: random allocations and frees of kernel object, stack and buffer sizes, the same sequence
+ * through mem_heap.c (pvPortMalloc() and mem_alloc() of one region) and through heap_4.c of the same
+ * total size (configTOTAL_HEAP_SIZE). Every block is filled and checked when freed (overlaps, alignment),
+ * and all the blocks are coalesced back to one free block per heap at the end. The scheduler suspension
+ * is the host kernel.c counter.
+ */
+
+#define OPS			2000000
+#define SLOTS		128
+
+/* heap_4.c functions - renamed by the Makefile */
+void* heap4_malloc(size_t size);
+void heap4_free(void* ptr);
+size_t heap4_free_size(void);
+void heap4_stats(HeapStats_t* stats);
+
+typedef struct{
+	const char* name;
+	void* (*alloc)(size_t size);
+	void (*free)(void* ptr);
+}heap_ops_t;
+
+typedef struct{
+	uint16_t slot;
+	uint16_t size;
+}heap_op_t;
+
+static heap_op_t ops[OPS];
+static uint8_t* live[SLOTS];
+static uint16_t live_size[SLOTS];
+
+static void* sram_alloc(size_t size){
+	return mem_alloc(MEM_REGION_SRAM, size);
+}
+
+static const heap_ops_t heaps[] = {
+	{"pvPortMalloc", pvPortMalloc, vPortFree},
+	{"mem_alloc SRAM", sram_alloc, mem_free},
+	{"heap_4", heap4_malloc, heap4_free},
+};
+
+/**
+ * @brief This function builds the operations - a slot to free or to allocate (sizes: mostly kernel
+ * 		  objects, some stacks and buffers)
+ * */
+static void build_ops(void){
+	uint32_t i, r;
+
+	for(i = 0; i < OPS; i++){
+		ops[i].slot = host_rand() % SLOTS;
+		r = host_rand() % 100;
+		if(r < 75){
+			ops[i].size = 8 + host_rand() % 120;
+		}
+		else if(r < 95){
+			ops[i].size = 128 + host_rand() % 896;
+		}
+		else{
+			ops[i].size = 1024 + host_rand() % 3072;
+		}
+	}
+}
+
+/**
+ * @brief This function fills a block with its slot pattern, or checks the pattern
+ * */
+static void pattern(uint32_t slot, int fill){
+	uint8_t value = (uint8_t)(slot * 37 + live_size[slot]);
+	uint32_t i;
+
+	for(i = 0; i < live_size[slot]; i++){
+		if(fill){
+			live[slot][i] = value + i;
+		}
+		else if(live[slot][i] != (uint8_t)(value + i)){
+			host_fail(__FILE__, __LINE__, "block overwritten");
+			return;
+		}
+	}
+}
+
+/**
+ * @brief This function runs the operations
+ *
+ * @param check Fill and check the blocks (the timed run only touches the first word)
+ *
+ * @return The failed allocations
+ * */
+static uint32_t run(const heap_ops_t* heap, int check){
+	uint32_t i, slot, fails = 0;
+
+	for(i = 0; i < OPS; i++){
+		slot = ops[i].slot;
+
+		if(live[slot]){
+			if(check){
+				pattern(slot, 0);
+			}
+			heap->free(live[slot]);
+			live[slot] = NULL;
+			continue;
+		}
+
+		live[slot] = heap->alloc(ops[i].size);
+		if(live[slot] == NULL){
+			fails++;
+			continue;
+		}
+
+		live_size[slot] = ops[i].size;
+		if(check){
+			CHECK(((uintptr_t)live[slot] & portBYTE_ALIGNMENT_MASK) == 0);
+			pattern(slot, 1);
+		}
+		else{
+			live[slot][0] = slot;
+		}
+	}
+
+	for(slot = 0; slot < SLOTS; slot++){
+		if(live[slot]){
+			if(check){
+				pattern(slot, 0);
+			}
+			heap->free(live[slot]);
+			live[slot] = NULL;
+		}
+	}
+
+	return fails;
+}
+
+/**
+ * @brief All the blocks are free and coalesced - one free block per heap
+ * */
+static void check_empty(void){
+	mem_heap_stats_t stats;
+	HeapStats_t heap4;
+	uint32_t r;
+
+	for(r = 0; r < MEM_REGION_NUM; r++){
+		mem_heap_get_stats((mem_region_t)r, &stats);
+		CHECK(stats.free == stats.size && stats.blocks == 1);
+		CHECK(stats.allocs == stats.frees);
+	}
+
+	// heap_4 is built by its first allocation
+	heap4_stats(&heap4);
+	if(heap4.xNumberOfSuccessfulAllocations == 0){
+		return;
+	}
+	CHECK(heap4.xNumberOfFreeBlocks == 1 && heap4.xAvailableHeapSpaceInBytes == heap4_free_size());
+	CHECK(heap4.xNumberOfSuccessfulAllocations == heap4.xNumberOfSuccessfulFrees);
+}
+
+int main(void){
+	uint64_t t0, ns;
+	uint32_t h, fails;
+
+	mem_heap_init();
+	build_ops();
+
+	printf("mem_heap: %u random alloc/free operations, %u slots\n", OPS, SLOTS);
+
+	for(h = 0; h < sizeof(heaps) / sizeof(heaps[0]); h++){
+		fails = run(&heaps[h], 1);
+		check_empty();
+
+		t0 = host_ns();
+		CHECK(run(&heaps[h], 0) == fails);
+		ns = host_ns() - t0;
+		check_empty();
+
+		printf("  %-14s %6.1f ns/op  %6lu failed allocations\n", heaps[h].name, (double)ns / OPS,
+				(unsigned long)fails);
+	}
+
+	CHECK(host_critical_nesting == 0);
+
+	return host_result("mem_heap bench");
+}
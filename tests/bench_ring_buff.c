@@ -0,0 +1,118 @@
+/*
+ * bench_ring_buff.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "ring_buff.h"
+#include "host.h"
+
+/*
+ * Console input throughput: the input ring (ring_buff.c) against the former 10 bytes q_data queue.
+ * The same command lines are received in bursts and extracted to a command_t:
+ *   queue - xQueueSendFromISR() per byte, xQueueReceive() per byte up to the end of line
+ *   ring  - ring_buff_write() per burst, ring_buff_find() and ring_buff_read() per line
+ * The kernel queue code is the target one (no scheduler, no waiting task). The host critical sections
+ * are free, so the queue cost on the target (BASEPRI writes per byte) is higher than measured here.
+ */
+
+#define STREAM_SIZE		(1 << 20)
+#define BURST			8		/* fits the queue */
+#define RUNS			20
+
+static uint8_t stream[STREAM_SIZE];
+static command_t cmd;
+static uint32_t lines;
+
+static QueueHandle_t q_data;
+static StaticQueue_t q_data_struct;
+static uint8_t q_data_storage[10];
+
+static uint8_t ring_storage[256];
+static ring_buff_t ring;
+
+/* Kernel hook - the tick does not run on the host */
+void vApplicationTickHook(void){
+}
+
+static void queue_run(void){
+	BaseType_t woken;
+	uint32_t i, j;
+	uint8_t ch;
+
+	for(i = 0; i < STREAM_SIZE; i += BURST){
+		// RX ISR
+		for(j = 0; j < BURST; j++){
+			xQueueSendFromISR(q_data, &stream[i + j], &woken);
+		}
+
+		// Command task
+		while(xQueueReceive(q_data, &ch, 0) == pdPASS){
+			cmd.payload[cmd.len++] = ch;
+			if(ch == '\n'){
+				lines++;
+				cmd.len = 0;
+			}
+		}
+	}
+}
+
+static void ring_run(void){
+	int32_t pos;
+	uint32_t i;
+
+	for(i = 0; i < STREAM_SIZE; i += BURST){
+		// RX ISR
+		ring_buff_write(&ring, &stream[i], BURST);
+
+		// Command task
+		while((pos = ring_buff_find(&ring, '\n')) >= 0){
+			cmd.len = ring_buff_read(&ring, (uint8_t*)cmd.payload, pos + 1);
+			lines++;
+		}
+	}
+}
+
+static double bench(const char* name, void (*run)(void)){
+	uint64_t start, best = UINT64_MAX;
+	uint32_t i;
+
+	for(i = 0; i < RUNS; i++){
+		lines = 0;
+		start = host_ns();
+		run();
+		start = host_ns() - start;
+		if(start < best){
+			best = start;
+		}
+	}
+
+	printf("  %-6s %8.1f MB/s  %6.2f ns/byte  (%lu lines)\n", name, STREAM_SIZE * 1e3 / best,
+			(double)best / STREAM_SIZE, (unsigned long)lines);
+
+	return (double)best;
+}
+
+int main(void){
+	double queue, ring_ns;
+	uint32_t i;
+
+	// Command lines of 4 to 24 bytes
+	for(i = 0; i < STREAM_SIZE; i++){
+		stream[i] = 'a' + host_rand() % 26;
+	}
+	for(i = 0; i < STREAM_SIZE; i += 4 + host_rand() % 21){
+		stream[i] = '\n';
+	}
+
+	q_data = xQueueCreateStatic(sizeof(q_data_storage), sizeof(char), q_data_storage, &q_data_struct);
+	ring_buff_init(&ring, ring_storage, sizeof(ring_storage));
+
+	printf("ring_buff: %u bytes in %u bytes bursts\n", STREAM_SIZE, BURST);
+	queue = bench("queue", queue_run);
+	ring_ns = bench("ring", ring_run);
+	printf("  ring / queue speedup %.1fx\n", queue / ring_ns);
+
+	return 0;
+}
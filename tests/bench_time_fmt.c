@@ -0,0 +1,171 @@
+/*
+ * bench_time_fmt.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdio.h>
+#include <string.h>
+#include "time_fmt.h"
+#include "host.h"
+
+/*
+ * The report line "Current Time&Date HH:MM:SS [AM] DD-MM-YYYY" and a 32 bits number written by the
+ * time_fmt writers against the former sprintf() calls. The outputs are compared first: every second of
+ * the day in both hour formats and every day of the RTC calendar, and the line truncated at every
+ * buffer end (nothing written after it).
+ */
+
+#define RUNS		1000000
+
+static char line[64];
+static char ref[64];
+
+/**
+ * @brief This function writes the report line with the time_fmt writers
+ * */
+static uint32_t fmt_line_n(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format,
+							uint32_t size){
+	const char* end = line + size;
+	char* p;
+
+	p = time_fmt_str(line, end, "Current Time&Date ");
+	p = time_fmt_time(p, end, sTime, hour_format);
+	p = time_fmt_chr(p, end, ' ');
+	p = time_fmt_date(p, end, sDate);
+	p = time_fmt_chr(p, end, '\n');
+
+	return p - line;
+}
+
+static uint32_t fmt_line(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format){
+	return fmt_line_n(sTime, sDate, hour_format, sizeof(line));
+}
+
+/**
+ * @brief This function writes the report line with sprintf() (the former rtc.c formats)
+ * */
+static uint32_t sprintf_line(const RTC_TimeTypeDef* sTime, const RTC_DateTypeDef* sDate, uint32_t hour_format){
+
+	if(hour_format == RTC_HOURFORMAT_12){
+		return sprintf(ref, "Current Time&Date %02d:%02d:%02d [%s] %02d-%02d-20%02d\n", sTime->Hours,
+				sTime->Minutes, sTime->Seconds, sTime->TimeFormat == RTC_HOURFORMAT12_AM ? "AM" : "PM",
+				sDate->Date, sDate->Month, sDate->Year);
+	}
+
+	return sprintf(ref, "Current Time&Date %02d:%02d:%02d %02d-%02d-20%02d\n", sTime->Hours, sTime->Minutes,
+			sTime->Seconds, sDate->Date, sDate->Month, sDate->Year);
+}
+
+/**
+ * @brief The writers output is the sprintf() output
+ * */
+static void check(void){
+	RTC_TimeTypeDef sTime = {0};
+	RTC_DateTypeDef sDate = {.Date = 17, .Month = 10, .Year = 26};
+	uint32_t secs, len, i, value;
+	uint32_t hour_format, full, size;
+
+	for(secs = 0; secs < 86400; secs++){
+		sTime.Hours = secs / 3600;
+		sTime.Minutes = secs / 60 % 60;
+		sTime.Seconds = secs % 60;
+
+		len = fmt_line(&sTime, &sDate, RTC_HOURFORMAT_24);
+		CHECK(len == sprintf_line(&sTime, &sDate, RTC_HOURFORMAT_24) && memcmp(line, ref, len) == 0);
+
+		sTime.TimeFormat = (sTime.Hours >= 12) ? RTC_HOURFORMAT12_PM : RTC_HOURFORMAT12_AM;
+		sTime.Hours = (sTime.Hours % 12) ? sTime.Hours % 12 : 12;
+		len = fmt_line(&sTime, &sDate, RTC_HOURFORMAT_12);
+		CHECK(len == sprintf_line(&sTime, &sDate, RTC_HOURFORMAT_12) && memcmp(line, ref, len) == 0);
+	}
+
+	for(sDate.Year = 0; sDate.Year < 100; sDate.Year++){
+		for(sDate.Month = 1; sDate.Month <= 12; sDate.Month++){
+			for(sDate.Date = 1; sDate.Date <= 31; sDate.Date++){
+				len = fmt_line(&sTime, &sDate, RTC_HOURFORMAT_24);
+				CHECK(len == sprintf_line(&sTime, &sDate, RTC_HOURFORMAT_24) && memcmp(line, ref, len) == 0);
+			}
+		}
+	}
+
+	for(i = 0; i < RUNS; i++){
+		value = (i < 64) ? ((i & 1) ? (1U << (i / 2)) - 1 : 1U << (i / 2)) : host_rand() >> (host_rand() % 32);
+		len = time_fmt_u32(line, line + sizeof(line), value) - line;
+		CHECK(len == (uint32_t)sprintf(ref, "%lu", (unsigned long)value) && memcmp(line, ref, len) == 0);
+	}
+
+	// Truncated at every size - the prefix of the full line, nothing written after the end
+	sTime = (RTC_TimeTypeDef){.Hours = 11, .Minutes = 59, .Seconds = 30, .TimeFormat = RTC_HOURFORMAT12_PM};
+	sDate = (RTC_DateTypeDef){.Date = 17, .Month = 10, .Year = 26};
+	for(hour_format = 0; hour_format < 2; hour_format++){
+		full = sprintf_line(&sTime, &sDate, hour_format ? RTC_HOURFORMAT_12 : RTC_HOURFORMAT_24);
+		for(size = 0; size <= full + 1; size++){
+			memset(line, '#', sizeof(line));
+			len = fmt_line_n(&sTime, &sDate, hour_format ? RTC_HOURFORMAT_12 : RTC_HOURFORMAT_24, size);
+			CHECK(len == (size < full ? size : full) && memcmp(line, ref, len) == 0);
+			CHECK(line[size] == '#');
+		}
+	}
+
+	for(size = 0; size <= TIME_FMT_U32_MAX; size++){
+		memset(line, '#', sizeof(line));
+		len = time_fmt_u32_align(line, line + size, 4294967295U, 12) - line;
+		CHECK(len == size && memcmp(line, "  4294967295", len) == 0 && line[size] == '#');
+	}
+}
+
+int main(void){
+	RTC_TimeTypeDef sTime = {.Hours = 11, .Minutes = 59, .Seconds = 30, .TimeFormat = RTC_HOURFORMAT12_PM};
+	RTC_DateTypeDef sDate = {.Date = 17, .Month = 10, .Year = 26};
+	uint64_t t0, fmt_ns, sprintf_ns;
+	uint32_t i, len = 0, value = 0;
+
+	check();
+
+	printf("time_fmt: ns per call (%u runs)\n", RUNS);
+
+	// Report line
+	t0 = host_ns();
+	for(i = 0; i < RUNS; i++){
+		sTime.Seconds = i % 60;
+		len += fmt_line(&sTime, &sDate, RTC_HOURFORMAT_12);
+		HOST_KEEP(line);
+	}
+	fmt_ns = host_ns() - t0;
+
+	t0 = host_ns();
+	for(i = 0; i < RUNS; i++){
+		sTime.Seconds = i % 60;
+		len += sprintf_line(&sTime, &sDate, RTC_HOURFORMAT_12);
+		HOST_KEEP(ref);
+	}
+	sprintf_ns = host_ns() - t0;
+
+	printf("  line     time_fmt %6.1f  sprintf %6.1f  (%.1fx)\n", (double)fmt_ns / RUNS,
+			(double)sprintf_ns / RUNS, (double)sprintf_ns / fmt_ns);
+
+	// 32 bits number
+	t0 = host_ns();
+	for(i = 0; i < RUNS; i++){
+		value = value * 1664525U + 1013904223U;
+		len += time_fmt_u32(line, line + sizeof(line), value) - line;
+		HOST_KEEP(line);
+	}
+	fmt_ns = host_ns() - t0;
+
+	t0 = host_ns();
+	for(i = 0; i < RUNS; i++){
+		value = value * 1664525U + 1013904223U;
+		len += sprintf(ref, "%lu", (unsigned long)value);
+		HOST_KEEP(ref);
+	}
+	sprintf_ns = host_ns() - t0;
+
+	printf("  u32      time_fmt %6.1f  sprintf %6.1f  (%.1fx)\n", (double)fmt_ns / RUNS,
+			(double)sprintf_ns / RUNS, (double)sprintf_ns / fmt_ns);
+
+	HOST_KEEP(len);
+
+	return host_result("time_fmt bench");
+}
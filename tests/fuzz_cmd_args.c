@@ -0,0 +1,186 @@
+/*
+ * fuzz_cmd_args.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "cmd_args.h"
+#include "host.h"
+
+/*
+ * args_parse() fuzz harness - the result is checked against a reference parse of the same line
+ * (strtoll() and strncasecmp()). Built with the address and undefined behavior sanitizers.
+ * The input: a schema byte, then the line. LLVMFuzzerTestOneInput() is the libFuzzer entry
+ * (clang -fsanitize=fuzzer -DHOST_LIBFUZZER), main() runs random lines made of the interesting characters.
+ */
+
+#define FUZZ_RUNS		2000000
+#define LINE_MAX		40
+
+static const char* const keywords[] = {"perf", "balanced", "low", "show", "a[", "@", NULL};
+
+static const arg_spec_t specs[] = {
+	{ARG_INT, INT32_MIN, INT32_MAX, NULL},
+	{ARG_INT, -5, 100, NULL},
+	{ARG_ENUM, 0, 0, keywords},
+	{ARG_STR, 0, 0, NULL},
+};
+
+#define SPECS_NUM		(sizeof(specs) / sizeof(specs[0]))
+
+/**
+ * @brief This function parses a token by the reference functions
+ * */
+static args_err_t reference(const char* tok, uint32_t len, const arg_spec_t* spec, arg_val_t* val){
+	char buff[LINE_MAX + 1];
+	char* end;
+	long long num;
+	uint32_t k;
+
+	memcpy(buff, tok, len);
+	buff[len] = '\0';
+
+	switch(spec->type){
+		case ARG_INT:
+			// strtoll() takes leading white space and a lone sign
+			if(len == 0 || !((buff[0] >= '0' && buff[0] <= '9') || ((buff[0] == '-' || buff[0] == '+') &&
+					len > 1 && buff[1] >= '0' && buff[1] <= '9'))){
+				return ARGS_ERR_NOT_NUMBER;
+			}
+			// The whole token - it may hold a zero byte
+			num = strtoll(buff, &end, 10);
+			if(end != &buff[len]){
+				return ARGS_ERR_NOT_NUMBER;
+			}
+			if(num < INT32_MIN || num > INT32_MAX){
+				return ARGS_ERR_OVERFLOW;
+			}
+			if(num < spec->min || num > spec->max){
+				return ARGS_ERR_RANGE;
+			}
+			val->num = (int32_t)num;
+			return ARGS_OK;
+
+		case ARG_ENUM:
+			for(k = 0; spec->keywords[k]; k++){
+				if(strlen(spec->keywords[k]) == len && strncasecmp(spec->keywords[k], buff, len) == 0){
+					val->idx = k;
+					return ARGS_OK;
+				}
+			}
+			return ARGS_ERR_KEYWORD;
+
+		default:
+			val->str.ptr = tok;
+			val->str.len = len;
+			return ARGS_OK;
+	}
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size){
+	const arg_spec_t* spec;
+	arg_val_t out[CMD_MAX_ARGS];
+	arg_val_t ref;
+	const char* line;
+	uint32_t nspec, len, pos, start, n, i;
+	uint32_t err_pos = UINT32_MAX;
+	args_err_t err, expected = ARGS_OK;
+	arg_spec_t schema[CMD_MAX_ARGS];
+	char* copy;
+
+	if(size < 1 || size > LINE_MAX + 1){
+		return 0;
+	}
+
+	// Schema: up to CMD_MAX_ARGS arguments of one type
+	spec = &specs[data[0] % SPECS_NUM];
+	nspec = (data[0] / SPECS_NUM) % (CMD_MAX_ARGS + 1);
+	len = size - 1;
+
+	// An exact size copy - the sanitizer catches a read past the line
+	copy = malloc(len ? len : 1);
+	memcpy(copy, &data[1], len);
+	line = copy;
+
+	for(i = 0; i < nspec; i++){
+		schema[i] = *spec;
+	}
+
+	err = args_parse(line, len, schema, nspec, out, &err_pos);
+
+	// Reference: the tokens in order, the first error wins
+	pos = 0;
+	n = 0;
+	start = 0;
+	while(expected == ARGS_OK){
+		while(pos < len && line[pos] == ' '){
+			pos++;
+		}
+		if(pos == len){
+			if(n < nspec){
+				expected = ARGS_ERR_MISSING;
+				start = pos;
+			}
+			break;
+		}
+		start = pos;
+		while(pos < len && line[pos] != ' '){
+			pos++;
+		}
+		if(n == nspec){
+			expected = ARGS_ERR_EXTRA;
+			break;
+		}
+		expected = reference(&line[start], pos - start, spec, &ref);
+		if(expected == ARGS_OK){
+			CHECK(out[n].type == spec->type);
+			if(spec->type == ARG_INT){
+				CHECK(out[n].num == ref.num);
+			}
+			else if(spec->type == ARG_ENUM){
+				CHECK(out[n].idx == ref.idx);
+			}
+			else{
+				CHECK(out[n].str.ptr == ref.str.ptr && out[n].str.len == ref.str.len);
+			}
+			n++;
+		}
+	}
+
+	CHECK(err == expected);
+	if(err != ARGS_OK){
+		CHECK(err_pos == start);
+	}
+	CHECK(args_err_msg(err) != NULL);
+
+	free(copy);
+
+	if(host_failures){
+		abort();
+	}
+
+	return 0;
+}
+
+#ifndef HOST_LIBFUZZER
+int main(void){
+	static const char chars[] = "0123456789 -+aAbBlLoOwWpPeErRfFsShH@`[{xX";
+	uint8_t data[LINE_MAX + 1];
+	uint32_t i, j, len;
+
+	for(i = 0; i < FUZZ_RUNS; i++){
+		len = host_rand() % sizeof(data);
+		data[0] = host_rand();
+		for(j = 1; j <= len; j++){
+			// Mostly the interesting characters, sometimes any byte
+			data[j] = (host_rand() % 16) ? chars[host_rand() % (sizeof(chars) - 1)] : host_rand();
+		}
+		LLVMFuzzerTestOneInput(data, len + 1);
+	}
+
+	return host_result("cmd_args fuzz");
+}
+#endif
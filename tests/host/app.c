@@ -0,0 +1,93 @@
+/*
+ * app.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "ao.h"
+#include "clk_profile.h"
+#include "cpu_stats.h"
+#include "dlog.h"
+#include "lp_idle.h"
+#include "mem_heap.h"
+#include "msg_pool.h"
+#include "rtc_cache.h"
+#include "rtc_report.h"
+#include "stack_mon.h"
+#include "host.h"
+
+/*
+ * The modules and the peripherals used by the command handlers of the tests that link the command
+ * tables (tasks_handler.c, led_effect.c, rtc.c) - the tests do not call the handlers, nothing is done.
+ */
+
+RTC_HandleTypeDef hrtc;
+TIM_HandleTypeDef htim7;
+QueueHandle_t q_print;
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void* const pvItemToQueue, TickType_t xTicksToWait,
+							 const BaseType_t xCopyPosition){
+	return pdTRUE;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState){
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim){
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef* hrtc, RTC_TimeTypeDef* sTime, uint32_t Format){
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef* hrtc, RTC_DateTypeDef* sDate, uint32_t Format){
+	return HAL_OK;
+}
+
+void* msg_pool_alloc(void){
+	return NULL;
+}
+
+void msg_pool_free(void* block){
+}
+
+void dlog_write(uint32_t id, uint32_t nargs, ...){
+}
+
+void rtc_cache_get(rtc_snapshot_t* snap){
+	memset(snap, 0, sizeof(*snap));
+}
+
+void rtc_cache_invalidate(void){
+}
+
+int32_t rtc_report_subscribe(uint32_t period, rtc_report_fmt_t fmt){
+	return -1;
+}
+
+void rtc_report_unsubscribe(int32_t id){
+}
+
+HAL_StatusTypeDef clk_profile_set(clk_profile_t profile){
+	return HAL_OK;
+}
+
+void ao_report(TickType_t timeout){
+}
+
+void clk_profile_report(TickType_t timeout){
+}
+
+void cpu_stats_report(TickType_t timeout){
+}
+
+void lp_idle_report(TickType_t timeout){
+}
+
+void mem_heap_report(TickType_t timeout){
+}
+
+void stack_mon_report(TickType_t timeout){
+}
@@ -0,0 +1,71 @@
+/*
+ * cmsis_host.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef __CMSIS_GCC_H
+#define __CMSIS_GCC_H
+
+#include <stdint.h>
+
+/*
+ * Host build of the CMSIS GCC layer - forced first (-include) and guarded as cmsis_gcc.h, so the device,
+ * HAL and kernel headers compile with the host gcc. The core instructions are host equivalents: the
+ * barriers are full memory barriers, the interrupt masks are variables.
+ */
+
+#define __ASM						__asm
+#define __INLINE					inline
+#define __STATIC_INLINE				static inline
+#define __STATIC_FORCEINLINE		__attribute__((always_inline)) static inline
+#define __NO_RETURN					__attribute__((__noreturn__))
+#define __USED						__attribute__((used))
+#define __WEAK						__attribute__((weak))
+#define __PACKED					__attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT				struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION				union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)				__attribute__((aligned(x)))
+#define __RESTRICT					__restrict
+#define __COMPILER_BARRIER()		__ASM volatile("":::"memory")
+
+#define __UNALIGNED_UINT16_READ(addr)			(*(const uint16_t*)(const void*)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)		(void)(*(uint16_t*)(void*)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)			(*(const uint32_t*)(const void*)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)		(void)(*(uint32_t*)(void*)(addr) = (val))
+
+#define __NOP()						__COMPILER_BARRIER()
+#define __WFI()						__COMPILER_BARRIER()
+#define __WFE()						__COMPILER_BARRIER()
+#define __SEV()						__COMPILER_BARRIER()
+#define __ISB()						__sync_synchronize()
+#define __DSB()						__sync_synchronize()
+#define __DMB()						__sync_synchronize()
+#define __BKPT(value)				__builtin_trap()
+
+/* Interrupt masks of the host build */
+extern uint32_t host_primask;
+extern uint32_t host_basepri;
+
+__STATIC_FORCEINLINE void __enable_irq(void){ host_primask = 0; }
+__STATIC_FORCEINLINE void __disable_irq(void){ host_primask = 1; }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void){ return host_primask; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask){ host_primask = primask; }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void){ return host_basepri; }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basepri){ host_basepri = basepri; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void){ return 0; }
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value){ return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value){
+	uint32_t result = 0;
+	uint32_t i;
+
+	for(i = 0; i < 32; i++, value >>= 1){
+		result = (result << 1) | (value & 1);
+	}
+	return result;
+}
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value){ return value ? (uint8_t)__builtin_clz(value) : 32; }
+
+#endif /* __CMSIS_GCC_H */
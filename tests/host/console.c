@@ -0,0 +1,27 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "host.h"
+
+/*
+ * Console output and LED functions of the tests that do not link tasks_handler.c and led_effect.c - the
+ * messages and the calls are recorded for the test.
+ */
+
+uint32_t host_console_msgs;
+const char* host_console_last;
+uint32_t host_leds_stops;
+
+BaseType_t queue_send_msg(const char* message, TickType_t timeout){
+	host_console_msgs++;
+	host_console_last = message;
+	return pdTRUE;
+}
+
+void leds_stop(void){
+	host_leds_stops++;
+}
@@ -0,0 +1,65 @@
+/*
+ * host.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <stdlib.h>
+#include <time.h>
+#include "host.h"
+
+uint32_t host_primask;
+uint32_t host_basepri;
+uint32_t host_critical_nesting;
+
+uint32_t host_failures;
+uint32_t host_tick;
+
+static uint32_t host_seed = 0x12345678;
+
+void host_fail(const char* file, int line, const char* expr){
+	if(host_failures++ < 20){
+		printf("%s:%d: CHECK failed: %s\n", file, line, expr);
+		fflush(stdout);
+	}
+}
+
+void host_assert(const char* file, int line){
+	printf("%s:%d: configASSERT failed\n", file, line);
+	abort();
+}
+
+/**
+ * @brief This function prints the test result
+ *
+ * @return The main() exit code - non zero if a check failed
+ * */
+int host_result(const char* name){
+	if(host_failures){
+		printf("%s: %lu checks failed\n", name, (unsigned long)host_failures);
+		return 1;
+	}
+
+	printf("%s: passed\n", name);
+	return 0;
+}
+
+/**
+ * @brief This function returns the monotonic time (ns)
+ * */
+uint64_t host_ns(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief This function returns a pseudo random number - the same sequence on every run (xorshift32)
+ * */
+uint32_t host_rand(void){
+	host_seed ^= host_seed << 13;
+	host_seed ^= host_seed >> 17;
+	host_seed ^= host_seed << 5;
+	return host_seed;
+}
@@ -0,0 +1,37 @@
+/*
+ * host.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Host tests and benchmarks helpers (tests/Makefile).
+ * A test returns host_result() from main - non zero when a CHECK failed.
+ */
+
+#define CHECK(x)	do{ if(!(x)){ host_fail(__FILE__, __LINE__, #x); } }while(0)
+
+/* Keeps a benchmark result alive - the loop is not optimized away */
+#define HOST_KEEP(x)	__asm volatile("" : : "g"(x) : "memory")
+
+extern uint32_t host_failures;
+extern uint32_t host_tick;		/* xTaskGetTickCount() of kernel.c */
+
+/* Recorded by console.c */
+extern uint32_t host_console_msgs;
+extern const char* host_console_last;
+extern uint32_t host_leds_stops;
+
+void host_fail(const char* file, int line, const char* expr);
+int host_result(const char* name);
+uint64_t host_ns(void);
+uint32_t host_rand(void);
+
+#endif /* HOST_H_ */
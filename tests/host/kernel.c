@@ -0,0 +1,27 @@
+/*
+ * kernel.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "host.h"
+
+/*
+ * Kernel functions of the tests that do not link the kernel sources - there is no scheduler, the tick
+ * count is set by the test.
+ */
+
+TickType_t xTaskGetTickCount(void){
+	return host_tick;
+}
+
+void vTaskSuspendAll(void){
+	host_critical_nesting++;
+}
+
+BaseType_t xTaskResumeAll(void){
+	host_critical_nesting--;
+	return pdFALSE;
+}
@@ -0,0 +1,68 @@
+/*
+ * portmacro.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+
+/*
+ * Host port of the kernel headers - replaces portable/GCC/ARM_CM4F/portmacro.h (not in the host include
+ * path). There is no scheduler: the tests run in one thread and call the kernel functions that work
+ * without it (e.g. the queues with no timeout). The critical sections count the nesting.
+ */
+
+#define portCHAR			char
+#define portFLOAT			float
+#define portDOUBLE			double
+#define portLONG			long
+#define portSHORT			short
+#define portSTACK_TYPE		uint32_t
+#define portBASE_TYPE		long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+typedef uint32_t TickType_t;
+#define portMAX_DELAY		(TickType_t)0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC		1
+
+#define portSTACK_GROWTH	(-1)
+#define portTICK_PERIOD_MS	((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT	8
+#define portPOINTER_SIZE_TYPE	uintptr_t
+#define portDONT_DISCARD	__attribute__((used))
+
+extern uint32_t host_critical_nesting;
+
+void host_assert(const char* file, int line);
+
+/* A failed assertion fails the test instead of the target hang */
+#undef configASSERT
+#define configASSERT(x)		if((x) == 0){ host_assert(__FILE__, __LINE__); }
+
+#define portYIELD()
+#define portEND_SWITCHING_ISR(xSwitchRequired)	(void)(xSwitchRequired)
+#define portYIELD_FROM_ISR(x)					portEND_SWITCHING_ISR(x)
+
+#define portSET_INTERRUPT_MASK_FROM_ISR()		(host_critical_nesting++, 0)
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)	((void)(x), host_critical_nesting--)
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portENTER_CRITICAL()					(host_critical_nesting++)
+#define portEXIT_CRITICAL()						(host_critical_nesting--)
+
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters)	void vFunction(void* pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters)			void vFunction(void* pvParameters)
+
+#define portNOP()
+#define portINLINE			__inline
+#define portFORCE_INLINE	inline __attribute__((always_inline))
+#define portMEMORY_BARRIER()	__asm volatile("":::"memory")
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,136 @@
+/*
+ * test_cmd_registry.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "main.h"
+#include "cmd_registry.h"
+#include "host.h"
+
+/*
+ * Perfect hash lookup of the registered command tables (menu_cmds, leds_cmds, rtc_cmds) - CMD_HASH_SEED is
+ * collision free, every name of every group, the names of the other groups, the prefixes, the extensions
+ * and random names.
+ */
+
+static const cmd_entry_t* const tables[] = {menu_cmds, leds_cmds, rtc_cmds};
+
+#define TABLES_NUM		(sizeof(tables) / sizeof(tables[0]))
+
+/**
+ * @brief This function returns the entry of a name in a group by a linear search
+ * */
+static const cmd_entry_t* find(cmd_group_t group, const char* name, uint32_t len){
+	const cmd_entry_t* entry;
+	uint32_t t;
+
+	for(t = 0; t < TABLES_NUM; t++){
+		for(entry = tables[t]; entry->name; entry++){
+			if(entry->group == group && strlen(entry->name) == len && memcmp(entry->name, name, len) == 0){
+				return entry;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief CMD_HASH_SEED places every command - otherwise prints the first collision free seed
+ * */
+static void test_seed(void){
+	uint32_t seed;
+
+	if(cmd_registry_build(CMD_HASH_SEED)){
+		return;
+	}
+
+	for(seed = 0; seed < 1000000; seed++){
+		if(cmd_registry_build(seed)){
+			printf("CMD_HASH_SEED collides, set it to %lu\n", (unsigned long)seed);
+			break;
+		}
+	}
+
+	host_fail(__FILE__, __LINE__, "CMD_HASH_SEED");
+}
+
+/**
+ * @brief Every name of every table is found in its group only, shorter and longer names are not
+ * */
+static void test_tables(void){
+	const cmd_entry_t* entry;
+	char name[16];
+	uint32_t t, len, count = 0;
+	cmd_group_t group;
+
+	for(t = 0; t < TABLES_NUM; t++){
+		for(entry = tables[t]; entry->name; entry++){
+			len = strlen(entry->name);
+			CHECK(len < sizeof(name) - 1);
+			count++;
+
+			CHECK(cmd_lookup(entry->group, entry->name, len) == entry);
+
+			for(group = 0; group < CMD_GROUP_NUM; group++){
+				CHECK(cmd_lookup(group, entry->name, len) == find(group, entry->name, len));
+			}
+
+			// Prefixes
+			for(; len > 0; len--){
+				CHECK(cmd_lookup(entry->group, entry->name, len - 1) == find(entry->group, entry->name, len - 1));
+			}
+
+			// Extensions - the name is not null terminated in the command line
+			len = strlen(entry->name);
+			memcpy(name, entry->name, len);
+			name[len] = 'x';
+			CHECK(cmd_lookup(entry->group, name, len + 1) == find(entry->group, name, len + 1));
+			CHECK(cmd_lookup(entry->group, name, len) == entry);
+		}
+	}
+
+	CHECK(count < CMD_HASH_SIZE);
+}
+
+/**
+ * @brief Random names match the linear search
+ * */
+static void test_random(void){
+	static const char chars[] = "0123456789abcdeilmnoprstuwxk ";
+	char name[8];
+	uint32_t i, j, len;
+	cmd_group_t group;
+
+	for(i = 0; i < 1000000; i++){
+		len = host_rand() % sizeof(name);
+		for(j = 0; j < len; j++){
+			name[j] = chars[host_rand() % (sizeof(chars) - 1)];
+		}
+		group = host_rand() % CMD_GROUP_NUM;
+
+		CHECK(cmd_lookup(group, name, len) == find(group, name, len));
+	}
+}
+
+/**
+ * @brief An unknown command is not dispatched
+ * */
+static void test_dispatch(void){
+	CHECK(cmd_dispatch(CMD_GROUP_MENU, "e1", 2) == CMD_ERR_NOT_FOUND);
+	CHECK(cmd_dispatch(CMD_GROUP_LEDS, "set 1", 5) == CMD_ERR_NOT_FOUND);
+	CHECK(cmd_dispatch(CMD_GROUP_RTC, "", 0) == CMD_ERR_NOT_FOUND);
+	CHECK(cmd_dispatch(CMD_GROUP_MENU, "stats1", 6) == CMD_ERR_NOT_FOUND);
+}
+
+int main(void){
+	test_seed();
+	cmd_registry_init();
+
+	test_tables();
+	test_random();
+	test_dispatch();
+
+	return host_result("cmd_registry");
+}
@@ -0,0 +1,114 @@
+/*
+ * test_cobs.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <string.h>
+#include "cobs.h"
+#include "host.h"
+
+/*
+ * Known encodings, random buffers encoded and decoded back (no zero byte in the encoded data, the size
+ * within COBS_ENC_MAX()) around the 254 bytes block boundaries, and the decoder errors.
+ */
+
+#define DATA_MAX	600
+
+/**
+ * @brief This function encodes a buffer and decodes it back
+ * */
+static void round_trip(const uint8_t* data, uint32_t len){
+	uint8_t enc[COBS_ENC_MAX(DATA_MAX) + 1];
+	uint8_t dec[DATA_MAX];
+	uint32_t n;
+
+	// Guard byte after the worst case size
+	enc[COBS_ENC_MAX(len)] = 0xA5;
+
+	n = cobs_encode(data, len, enc);
+	CHECK(n >= len + 1 && n <= COBS_ENC_MAX(len));
+	CHECK(enc[COBS_ENC_MAX(len)] == 0xA5);
+	CHECK(memchr(enc, 0, n) == NULL);
+
+	CHECK(cobs_decode(enc, n, dec, len) == (int32_t)len);
+	CHECK(memcmp(data, dec, len) == 0);
+
+	// One byte short of the output
+	if(len){
+		CHECK(cobs_decode(enc, n, dec, len - 1) == -1);
+	}
+}
+
+/**
+ * @brief The encodings of the COBS paper examples
+ * */
+static void test_known(void){
+	static const struct{
+		uint8_t data[8];
+		uint32_t len;
+		uint8_t enc[8];
+		uint32_t enc_len;
+	}vectors[] = {
+		{{0}, 0, {0x01}, 1},
+		{{0x00}, 1, {0x01, 0x01}, 2},
+		{{0x00, 0x00}, 2, {0x01, 0x01, 0x01}, 3},
+		{{0x11, 0x22, 0x00, 0x33}, 4, {0x03, 0x11, 0x22, 0x02, 0x33}, 5},
+		{{0x11, 0x22, 0x33, 0x44}, 4, {0x05, 0x11, 0x22, 0x33, 0x44}, 5},
+		{{0x11, 0x00, 0x00, 0x00}, 4, {0x02, 0x11, 0x01, 0x01, 0x01}, 5},
+	};
+	uint8_t enc[8];
+	uint32_t i;
+
+	for(i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++){
+		CHECK(cobs_encode(vectors[i].data, vectors[i].len, enc) == vectors[i].enc_len);
+		CHECK(memcmp(enc, vectors[i].enc, vectors[i].enc_len) == 0);
+		round_trip(vectors[i].data, vectors[i].len);
+	}
+}
+
+/**
+ * @brief Random buffers - all zeros, no zero and mixed, every length around the block boundaries
+ * */
+static void test_round_trip(void){
+	uint8_t data[DATA_MAX];
+	uint32_t len, zeros, i, r;
+
+	for(zeros = 0; zeros <= 100; zeros += 25){
+		for(len = 0; len <= DATA_MAX; len++){
+			// The lengths far from the boundaries at random
+			if(len % 254 > 2 && len % 254 < 252 && host_rand() % 8){
+				continue;
+			}
+
+			for(i = 0; i < len; i++){
+				r = host_rand();
+				data[i] = (r % 100 < zeros) ? 0 : 1 + (r >> 8) % 255;
+			}
+			round_trip(data, len);
+		}
+	}
+}
+
+/**
+ * @brief Invalid encodings are rejected
+ * */
+static void test_errors(void){
+	static const uint8_t zero[] = {0x03, 0x11, 0x00};
+	static const uint8_t code_zero[] = {0x02, 0x11, 0x00, 0x22};
+	static const uint8_t truncated[] = {0x05, 0x11, 0x22};
+	uint8_t dec[8];
+
+	CHECK(cobs_decode(zero, sizeof(zero), dec, sizeof(dec)) == -1);
+	CHECK(cobs_decode(code_zero, sizeof(code_zero), dec, sizeof(dec)) == -1);
+	CHECK(cobs_decode(truncated, sizeof(truncated), dec, sizeof(dec)) == -1);
+	CHECK(cobs_decode(zero, 0, dec, sizeof(dec)) == 0);
+}
+
+int main(void){
+	test_known();
+	test_round_trip();
+	test_errors();
+
+	return host_result("cobs");
+}
@@ -0,0 +1,103 @@
+/*
+ * test_epoch.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <time.h>
+#include "epoch.h"
+#include "host.h"
+
+/*
+ * Every day of 2000 - 2099 against the host gmtime(): the day, the week day, the month length, the
+ * time of the day (first, last and a random second) in seconds and milliseconds, and the RTC fields
+ * in the 24 and 12 hours formats.
+ */
+
+/**
+ * @brief This function checks a calendar time against gmtime()
+ * */
+static void check_civil(const civil_time_t* ct, const struct tm* tm){
+	CHECK(ct->year == tm->tm_year + 1900);
+	CHECK(ct->month == tm->tm_mon + 1);
+	CHECK(ct->day == tm->tm_mday);
+	CHECK(ct->hours == tm->tm_hour);
+	CHECK(ct->minutes == tm->tm_min);
+	CHECK(ct->seconds == tm->tm_sec);
+	CHECK(ct->weekday == (tm->tm_wday ? tm->tm_wday : RTC_WEEKDAY_SUNDAY));
+}
+
+/**
+ * @brief This function checks a second of a day
+ * */
+static void check_time(uint32_t secs){
+	time_t t = secs;
+	struct tm tm;
+	civil_time_t ct;
+	RTC_TimeTypeDef sTime;
+	RTC_DateTypeDef sDate;
+	uint64_t ms;
+	uint32_t frac;
+
+	gmtime_r(&t, &tm);
+
+	epoch_to_civil(secs, &ct);
+	check_civil(&ct, &tm);
+	CHECK(epoch_from_civil(&ct) == secs);
+
+	frac = host_rand() % 1000;
+	ms = (uint64_t)secs * 1000 + frac;
+	CHECK(epoch_ms_to_civil(ms, &ct) == frac);
+	check_civil(&ct, &tm);
+	CHECK(epoch_ms_from_civil(&ct, frac) == ms);
+
+	// RTC registers - 24 hours
+	epoch_to_rtc(secs, RTC_HOURFORMAT_24, &sTime, &sDate);
+	CHECK(sTime.Hours == tm.tm_hour);
+	CHECK(sDate.Year == tm.tm_year + 1900 - EPOCH_RTC_YEAR_BASE);
+	CHECK(epoch_from_rtc(&sTime, &sDate, RTC_HOURFORMAT_24) == secs);
+
+	// 12 hours - 12 AM is 00, 12 PM is 12
+	epoch_to_rtc(secs, RTC_HOURFORMAT_12, &sTime, &sDate);
+	CHECK(sTime.Hours >= 1 && sTime.Hours <= 12);
+	CHECK(sTime.Hours % 12 == tm.tm_hour % 12);
+	CHECK(sTime.TimeFormat == (tm.tm_hour >= 12 ? RTC_HOURFORMAT12_PM : RTC_HOURFORMAT12_AM));
+	CHECK(epoch_from_rtc(&sTime, &sDate, RTC_HOURFORMAT_12) == secs);
+}
+
+int main(void){
+	uint32_t first, last, days, count = 0;
+	civil_time_t ct;
+	struct tm tm;
+	time_t t;
+
+	first = epoch_days_from_civil(EPOCH_YEAR_MIN, 1, 1);
+	last = epoch_days_from_civil(EPOCH_YEAR_MAX, 12, 31);
+
+	CHECK(first * 86400ULL == 946684800ULL);
+	CHECK(last * 86400ULL == 4102358400ULL);
+
+	for(days = first; days <= last; days++){
+		t = (time_t)days * 86400;
+		gmtime_r(&t, &tm);
+
+		epoch_civil_from_days(days, &ct);
+		CHECK(ct.year == tm.tm_year + 1900 && ct.month == tm.tm_mon + 1 && ct.day == tm.tm_mday);
+		CHECK(epoch_days_from_civil(ct.year, ct.month, ct.day) == days);
+		CHECK(epoch_weekday(days) == (tm.tm_wday ? tm.tm_wday : RTC_WEEKDAY_SUNDAY));
+
+		// The last day of the month
+		t += 86400;
+		gmtime_r(&t, &tm);
+		CHECK((tm.tm_mday == 1) == (ct.day == epoch_month_days(ct.year, ct.month)));
+
+		check_time(days * 86400);
+		check_time(days * 86400 + 86399);
+		check_time(days * 86400 + host_rand() % 86400);
+		count++;
+	}
+
+	CHECK(count == 36525);
+
+	return host_result("epoch");
+}
@@ -0,0 +1,257 @@
+/*
+ * test_hsm.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <string.h>
+#include "main.h"
+#include "app_hsm.h"
+#include "host.h"
+
+/*
+ * The console state machine (app_hsm.c): every state and event pair of the transitions, against the
+ * expected target and the expected exit and entry sequence (the states tree with recording actions).
+ * The actions of the states (host/console.c records the output and leds_stop()), hsm_start(), hsm_in()
+ * and the hsm_init() errors of invalid tables.
+ */
+
+/* Expected transitions - "-X" exit, "+X" entry, by the state letters below. NULL: unhandled. */
+static const char state_names[sNum] = {
+	[sMainMenu] = 'M', [sMainIdle] = 'I', [sLedEffect] = 'L', [sRtcMenu] = 'R',
+	[sRtcTimeConfig] = 'T', [sRtcDateConfig] = 'D', [sRtcReport] = 'P',
+};
+
+typedef struct{
+	uint8_t target;
+	const char* seq;
+}expected_t;
+
+#define NONE	{HSM_NONE, NULL}
+
+static const expected_t expected[sNum][evNum] = {
+	[sMainMenu] = {
+		[evLeds] = {sLedEffect, "-M+L"}, [evRtc] = {sRtcMenu, "-M+R"}, [evBack] = NONE,
+		[evIdle] = {sMainIdle, "+I"}, [evDone] = {sMainMenu, "-M+M"},
+		[evTime] = NONE, [evDate] = NONE, [evReport] = NONE,
+	},
+	[sMainIdle] = {
+		[evLeds] = {sLedEffect, "-I-M+L"}, [evRtc] = {sRtcMenu, "-I-M+R"}, [evBack] = NONE,
+		[evIdle] = {sMainIdle, "-I+I"}, [evDone] = {sMainMenu, "-I-M+M"},
+		[evTime] = NONE, [evDate] = NONE, [evReport] = NONE,
+	},
+	[sLedEffect] = {
+		[evLeds] = NONE, [evRtc] = NONE, [evBack] = {sMainMenu, "-L+M"},
+		[evIdle] = NONE, [evDone] = NONE,
+		[evTime] = NONE, [evDate] = NONE, [evReport] = NONE,
+	},
+	[sRtcMenu] = {
+		[evLeds] = NONE, [evRtc] = NONE, [evBack] = {sMainMenu, "-R+M"},
+		[evIdle] = NONE, [evDone] = {sRtcMenu, "-R+R"},
+		[evTime] = {sRtcTimeConfig, "+T"}, [evDate] = {sRtcDateConfig, "+D"}, [evReport] = {sRtcReport, "+P"},
+	},
+	[sRtcTimeConfig] = {
+		[evLeds] = NONE, [evRtc] = NONE, [evBack] = {sMainMenu, "-T-R+M"},
+		[evIdle] = NONE, [evDone] = {sRtcMenu, "-T-R+R"},
+		[evTime] = {sRtcTimeConfig, "-T+T"}, [evDate] = {sRtcDateConfig, "-T+D"}, [evReport] = {sRtcReport, "-T+P"},
+	},
+	[sRtcDateConfig] = {
+		[evLeds] = NONE, [evRtc] = NONE, [evBack] = {sMainMenu, "-D-R+M"},
+		[evIdle] = NONE, [evDone] = {sRtcMenu, "-D-R+R"},
+		[evTime] = {sRtcTimeConfig, "-D+T"}, [evDate] = {sRtcDateConfig, "-D+D"}, [evReport] = {sRtcReport, "-D+P"},
+	},
+	[sRtcReport] = {
+		[evLeds] = NONE, [evRtc] = NONE, [evBack] = {sMainMenu, "-P-R+M"},
+		[evIdle] = NONE, [evDone] = {sRtcMenu, "-P-R+R"},
+		[evTime] = {sRtcTimeConfig, "-P+T"}, [evDate] = {sRtcDateConfig, "-P+D"}, [evReport] = {sRtcReport, "-P+P"},
+	},
+};
+
+/* Recorded actions */
+static char seq[64];
+static uint32_t seq_len;
+
+static void record(char action, state_t state){
+	if(seq_len < sizeof(seq) - 2){
+		seq[seq_len++] = action;
+		seq[seq_len++] = state_names[state];
+		seq[seq_len] = '\0';
+	}
+}
+
+#define RECORDERS(s) \
+	static void entry_##s(void){ record('+', s); } \
+	static void exit_##s(void){ record('-', s); }
+
+RECORDERS(sMainMenu)
+RECORDERS(sMainIdle)
+RECORDERS(sLedEffect)
+RECORDERS(sRtcMenu)
+RECORDERS(sRtcTimeConfig)
+RECORDERS(sRtcDateConfig)
+RECORDERS(sRtcReport)
+
+static const hsm_action_t entries[sNum] = {
+	entry_sMainMenu, entry_sMainIdle, entry_sLedEffect, entry_sRtcMenu,
+	entry_sRtcTimeConfig, entry_sRtcDateConfig, entry_sRtcReport,
+};
+
+static const hsm_action_t exits[sNum] = {
+	exit_sMainMenu, exit_sMainIdle, exit_sLedEffect, exit_sRtcMenu,
+	exit_sRtcTimeConfig, exit_sRtcDateConfig, exit_sRtcReport,
+};
+
+/**
+ * @brief The actions of the console states
+ * */
+static void test_actions(void){
+	static const hsm_state_t actions[sNum] = {
+		[sMainMenu]      = {HSM_NONE,  menu_entry, NULL},
+		[sMainIdle]      = {sMainMenu, NULL,       NULL},
+		[sLedEffect]     = {HSM_NONE,  leds_entry, leds_stop},
+		[sRtcMenu]       = {HSM_NONE,  rtc_entry,  NULL},
+		[sRtcTimeConfig] = {sRtcMenu,  NULL,       NULL},
+		[sRtcDateConfig] = {sRtcMenu,  NULL,       NULL},
+		[sRtcReport]     = {sRtcMenu,  NULL,       NULL},
+	};
+	const hsm_state_t* app_states = app_hsm_def.states;
+	uint32_t s;
+
+	CHECK(app_hsm_def.nstates == sNum && app_hsm_def.nevents == evNum);
+	CHECK(app_hsm_def.initial == sMainMenu);
+
+	for(s = 0; s < sNum; s++){
+		CHECK(app_states[s].parent == actions[s].parent);
+		CHECK(app_states[s].entry == actions[s].entry);
+		CHECK(app_states[s].exit == actions[s].exit);
+	}
+
+	// The entry actions show the menus, the LEDs exit stops the effect
+	host_console_msgs = 0;
+	menu_entry();
+	CHECK(host_console_msgs == 1 && strstr(host_console_last, "MENU"));
+	leds_entry();
+	CHECK(host_console_msgs == 2 && strstr(host_console_last, "LEDs"));
+	rtc_entry();
+	CHECK(host_console_msgs == 4 && strstr(host_console_last, "Enter your choice"));
+
+	host_leds_stops = 0;
+	app_states[sLedEffect].exit();
+	CHECK(host_leds_stops == 1);
+}
+
+/**
+ * @brief Every state and event pair - the target, the actions sequence, the current state after it
+ * */
+static void test_transitions(void){
+	static hsm_state_t states[sNum];
+	static uint8_t table[HSM_TABLE_SIZE(sNum, evNum)];
+	const hsm_state_t* app_states = app_hsm_def.states;
+	hsm_def_t def = app_hsm_def;
+	const expected_t* exp;
+	hsm_t hsm;
+	uint32_t s, e, p;
+
+	// The console table as it is
+	CHECK(hsm_init(&hsm, &app_hsm_def, table) == HSM_OK);
+	for(s = 0; s < sNum; s++){
+		for(e = 0; e < evNum; e++){
+			CHECK(table[s * evNum + e] == expected[s][e].target);
+		}
+	}
+
+	// The same tree and transitions, recording actions
+	for(s = 0; s < sNum; s++){
+		states[s].parent = app_states[s].parent;
+		states[s].entry = entries[s];
+		states[s].exit = exits[s];
+	}
+	def.states = states;
+	CHECK(hsm_init(&hsm, &def, table) == HSM_OK);
+
+	seq_len = 0;
+	hsm_start(&hsm);
+	CHECK(strcmp(seq, "+M") == 0 && hsm_state(&hsm) == sMainMenu);
+
+	for(s = 0; s < sNum; s++){
+		for(e = 0; e < evNum; e++){
+			exp = &expected[s][e];
+
+			hsm.current = s;
+			seq_len = 0;
+			seq[0] = '\0';
+
+			CHECK(hsm_dispatch(&hsm, e) == (exp->target != HSM_NONE));
+			if(exp->target == HSM_NONE){
+				CHECK(seq_len == 0 && hsm_state(&hsm) == s);
+				continue;
+			}
+
+			if(strcmp(seq, exp->seq) != 0){
+				printf("state %c event %lu: %s, expected %s\n", state_names[s], (unsigned long)e, seq, exp->seq);
+				host_fail(__FILE__, __LINE__, "actions sequence");
+			}
+			CHECK(hsm_state(&hsm) == exp->target);
+
+			// In the target and its parents only
+			for(p = 0; p < sNum; p++){
+				CHECK(hsm_in(&hsm, p) == (p == exp->target || p == states[exp->target].parent));
+			}
+		}
+
+		// Out of range events are not handled
+		hsm.current = s;
+		CHECK(hsm_dispatch(&hsm, evNum) == 0 && hsm_dispatch(&hsm, HSM_NONE) == 0);
+		CHECK(hsm_state(&hsm) == s);
+	}
+}
+
+/**
+ * @brief Invalid tables are rejected
+ * */
+static void test_errors(void){
+	static const hsm_state_t loop[] = {{HSM_NONE, NULL, NULL}, {2, NULL, NULL}, {1, NULL, NULL}};
+	static const hsm_state_t deep[] = {
+		{HSM_NONE, NULL, NULL}, {0, NULL, NULL}, {1, NULL, NULL}, {2, NULL, NULL}, {3, NULL, NULL}
+	};
+	static const hsm_state_t flat[] = {{HSM_NONE, NULL, NULL}, {HSM_NONE, NULL, NULL}};
+	static const hsm_transition_t to_1[] = {{0, 0, 1}};
+	static const hsm_transition_t twice[] = {{0, 0, 1}, {0, 0, 0}};
+	static const hsm_transition_t bad_target[] = {{0, 0, 2}};
+	static const hsm_transition_t bad_event[] = {{0, 1, 1}};
+	uint8_t table[HSM_TABLE_SIZE(5, 1)];
+	hsm_def_t def;
+	hsm_t hsm;
+
+	def = (hsm_def_t){flat, to_1, 2, 1, 1, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_OK);
+
+	def = (hsm_def_t){flat, to_1, 2, 1, 1, 2};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_SIZE);
+	def = (hsm_def_t){flat, to_1, 2, 0, 1, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_SIZE);
+
+	def = (hsm_def_t){loop, NULL, 3, 1, 0, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_PARENT);
+	def = (hsm_def_t){deep, NULL, 5, 1, 0, 4};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_PARENT);
+
+	def = (hsm_def_t){flat, bad_target, 2, 1, 1, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_TRANSITION);
+	def = (hsm_def_t){flat, bad_event, 2, 1, 1, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_TRANSITION);
+
+	def = (hsm_def_t){flat, twice, 2, 1, 2, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_DUPLICATE);
+
+	def = (hsm_def_t){flat, NULL, 2, 1, 0, 0};
+	CHECK(hsm_init(&hsm, &def, table) == HSM_ERR_UNREACHABLE);
+}
+
+int main(void){
+	test_actions();
+	test_transitions();
+	test_errors();
+
+	return host_result("hsm");
+}
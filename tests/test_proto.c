@@ -0,0 +1,363 @@
+/*
+ * test_proto.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include <string.h>
+#include "main.h"
+#include "host.h"
+
+/* The CRC peripheral is a plain register block - the tests do not check the CRC value */
+static CRC_TypeDef host_crc;
+#undef CRC
+#define CRC		(&host_crc)
+
+/* The reception state and the response encoding are static - the module is part of the test */
+#include "../Core/Src/proto.c"
+
+/*
+ * The input ring replayed like the command task: a frame arriving a byte at a time, stray and doubled
+ * delimiters, a stray zero byte before a text line (timeout), overlong, short and unterminated frames.
+ * The responses through a full print queue and an exhausted message pool.
+ */
+
+#define RING_SIZE		128
+
+static uint8_t ring_data[RING_SIZE];
+static ring_buff_t ring;
+
+/* Command slots */
+static command_t slots[CMD_POOL_SIZE];
+static uint8_t slot_used[CMD_POOL_SIZE];
+
+/* Posted requests */
+static command_t* posted[CMD_POOL_SIZE];
+static uint32_t posted_num;
+
+/* Print queue and message pool */
+static uint8_t msg_block[MSG_POOL_BLOCK_SIZE];
+static uint32_t msg_used;
+static uint32_t msg_frees;
+static uint32_t pool_empty;
+static uint32_t queue_full;
+static const uint8_t* sent;
+static uint32_t sent_len;
+
+command_t* cmd_alloc(void){
+	uint32_t i;
+
+	for(i = 0; i < CMD_POOL_SIZE; i++){
+		if(!slot_used[i]){
+			slot_used[i] = 1;
+			return &slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+void cmd_release(command_t* cmd){
+	slot_used[cmd - slots] = 0;
+}
+
+BaseType_t ao_post(ao_t* me, const ao_event_t* e){
+	CHECK(me == &proto_ao && e->sig == PROTO_SIG_FRAME);
+	posted[posted_num++] = e->data;
+	return pdTRUE;
+}
+
+void* msg_pool_alloc(void){
+	if(pool_empty || msg_used){
+		return NULL;
+	}
+
+	msg_used = 1;
+	return msg_block;
+}
+
+void msg_pool_free(void* block){
+	CHECK(block == msg_block && msg_used);
+	msg_used = 0;
+	msg_frees++;
+}
+
+/* Like tasks_handler.c - the block is released when it can't be queued */
+BaseType_t queue_send_buff(const uint8_t* msg, uint32_t len, tx_release_t release, TickType_t timeout){
+	CHECK(timeout == pdMS_TO_TICKS(PROTO_TX_TIMEOUT_MS));
+
+	if(queue_full){
+		release((void*)msg);
+		return pdFALSE;
+	}
+
+	sent = msg;
+	sent_len = len;
+	return pdTRUE;
+}
+
+/**
+ * @brief This function reads the ring like the command task
+ *
+ * @return Non zero value when a partial frame waits in the ring
+ * */
+static int receive(void){
+	while(proto_frame_start(&ring)){
+		if(proto_receive(&ring)){
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief This function releases the posted requests
+ * */
+static void release_posted(void){
+	while(posted_num){
+		cmd_release(posted[--posted_num]);
+	}
+}
+
+/**
+ * @brief This function builds a request frame on the line: delimiter, COBS data, delimiter
+ *
+ * @return The line length
+ * */
+static uint32_t build_line(uint8_t seq, const uint8_t* data, uint32_t len, uint8_t* line){
+	uint8_t frame[PROTO_FRAME_MAX];
+	uint32_t n;
+
+	frame[0] = PROTO_VERSION;
+	frame[1] = seq;
+	frame[2] = PROTO_CMD_PING;
+	memcpy(&frame[PROTO_HDR_SIZE], data, len);
+	len += PROTO_HDR_SIZE;
+	proto_put_u32(&frame[len], 0x00C0FFEE);
+	len += PROTO_CRC_SIZE;
+
+	line[0] = PROTO_DELIM;
+	n = 1 + cobs_encode(frame, len, &line[1]);
+	line[n++] = PROTO_DELIM;
+
+	return n;
+}
+
+/**
+ * @brief This function checks a posted request against its frame
+ * */
+static void check_posted(uint32_t i, uint8_t seq, const uint8_t* data, uint32_t len){
+	const uint8_t* req = (const uint8_t*)posted[i]->payload;
+
+	CHECK(posted[i]->len == PROTO_HDR_SIZE + len + PROTO_CRC_SIZE);
+	CHECK(req[0] == PROTO_VERSION && req[1] == seq && req[2] == PROTO_CMD_PING);
+	CHECK(memcmp(&req[PROTO_HDR_SIZE], data, len) == 0);
+	CHECK(proto_get_u32(&req[PROTO_HDR_SIZE + len]) == 0x00C0FFEE);
+}
+
+/**
+ * @brief A frame arriving a byte at a time waits for its end delimiter, then it is posted
+ * */
+static void test_partial(void){
+	static const uint8_t data[] = {0x00, 0x11, 0x00, 0x00, 0x22};
+	uint8_t line[COBS_ENC_MAX(PROTO_FRAME_MAX) + 2];
+	uint32_t n, i;
+
+	n = build_line(7, data, sizeof(data), line);
+
+	for(i = 0; i < n - 1; i++){
+		ring_buff_write(&ring, &line[i], 1);
+		CHECK(receive() == -1);
+		CHECK(posted_num == 0);
+
+		// The timeout runs from the first byte
+		host_tick++;
+		CHECK(proto_rx_wait() == pdMS_TO_TICKS(PROTO_RX_TIMEOUT_MS) - 1 - i);
+	}
+
+	ring_buff_write(&ring, &line[n - 1], 1);
+	CHECK(receive() == 0);
+	CHECK(posted_num == 1);
+	check_posted(0, 7, data, sizeof(data));
+
+	CHECK(ring_buff_count(&ring) == 0);
+	CHECK(proto_rx_wait() == portMAX_DELAY);
+	CHECK(proto_stats.bad_frames == 0 && proto_stats.timeouts == 0);
+
+	release_posted();
+}
+
+/**
+ * @brief Stray delimiters between the frames are skipped, a stray zero byte before a text line is
+ * 		  dropped at the timeout and the line is kept for the text menu
+ * */
+static void test_stray(void){
+	static const uint8_t data[] = {0x5A};
+	static const uint8_t delims[] = {PROTO_DELIM, PROTO_DELIM, PROTO_DELIM};
+	static const char text[] = "led 1\n";
+	uint8_t line[COBS_ENC_MAX(PROTO_FRAME_MAX) + 2];
+	uint32_t n;
+
+	// Doubled delimiters before and between two frames
+	ring_buff_write(&ring, delims, sizeof(delims));
+	n = build_line(1, data, sizeof(data), line);
+	ring_buff_write(&ring, line, n);
+	ring_buff_write(&ring, delims, 1);
+	n = build_line(2, data, sizeof(data), line);
+	ring_buff_write(&ring, line, n);
+
+	CHECK(receive() == 0);
+	CHECK(posted_num == 2);
+	check_posted(0, 1, data, sizeof(data));
+	check_posted(1, 2, data, sizeof(data));
+	CHECK(ring_buff_count(&ring) == 0);
+	release_posted();
+
+	// A trailing delimiter waits like a frame start, it is dropped at the timeout
+	ring_buff_write(&ring, delims, 1);
+	ring_buff_write(&ring, (const uint8_t*)text, sizeof(text) - 1);
+
+	CHECK(receive() == -1);
+	host_tick += PROTO_RX_TIMEOUT_MS - 1;
+	CHECK(receive() == -1 && proto_rx_wait() == 1);
+	host_tick++;
+	CHECK(proto_rx_wait() == 0);
+	CHECK(receive() == 0);
+
+	CHECK(proto_stats.timeouts == 1);
+	CHECK(proto_rx_wait() == portMAX_DELAY);
+	CHECK(ring_buff_count(&ring) == sizeof(text) - 1);
+	CHECK(ring_buff_find(&ring, '\n') == sizeof(text) - 2);
+	CHECK(posted_num == 0 && proto_stats.bad_frames == 0);
+
+	ring_buff_consume(&ring, sizeof(text) - 1);
+	proto_stats.timeouts = 0;
+}
+
+/**
+ * @brief Overlong, short, invalid and unterminated frames are dropped and counted, the longest frame
+ * 		  and the next frames are received
+ * */
+static void test_bad_frames(void){
+	static const uint8_t data[] = {0x01, 0x02};
+	static const uint8_t longest[PROTO_FRAME_MAX - PROTO_HDR_SIZE - PROTO_CRC_SIZE] = {0x00, 0x44, [20] = 0x66};
+	static const uint8_t cobs_error[] = {PROTO_DELIM, 0x09, 0x11, PROTO_DELIM};
+	static const uint8_t too_short[] = {PROTO_DELIM, 0x03, 0x01, 0x07, PROTO_DELIM};
+	uint8_t line[RING_SIZE];
+	uint32_t n, i;
+
+	// Encoded longer than a frame can be
+	line[0] = PROTO_DELIM;
+	for(i = 1; i <= COBS_ENC_MAX(PROTO_FRAME_MAX) + 1; i++){
+		line[i] = 0x55;
+	}
+	line[i++] = PROTO_DELIM;
+	ring_buff_write(&ring, line, i);
+
+	// The longest frame is received
+	n = build_line(8, longest, sizeof(longest), line);
+	CHECK(n - 2 <= COBS_ENC_MAX(PROTO_FRAME_MAX));
+	ring_buff_write(&ring, line, n);
+
+	ring_buff_write(&ring, cobs_error, sizeof(cobs_error));
+	ring_buff_write(&ring, too_short, sizeof(too_short));
+
+	n = build_line(9, data, sizeof(data), line);
+	ring_buff_write(&ring, line, n);
+
+	CHECK(receive() == 0);
+	CHECK(proto_stats.bad_frames == 3);
+	CHECK(posted_num == 2);
+	check_posted(0, 8, longest, sizeof(longest));
+	check_posted(1, 9, data, sizeof(data));
+	CHECK(ring_buff_count(&ring) == 0);
+	release_posted();
+
+	// The invalid frames release their slots
+	for(i = 0; i < CMD_POOL_SIZE; i++){
+		CHECK(slot_used[i] == 0);
+	}
+
+	// A full ring without an end delimiter is dropped - no frame, the task waits for new data
+	memset(line, 0x55, sizeof(line));
+	line[0] = PROTO_DELIM;
+	ring_buff_write(&ring, line, RING_SIZE);
+
+	CHECK(receive() == -1);
+	CHECK(proto_stats.bad_frames == 4);
+	CHECK(ring_buff_count(&ring) == 0);
+	CHECK(proto_rx_wait() == portMAX_DELAY);
+	CHECK(posted_num == 0);
+
+	proto_stats.bad_frames = 0;
+}
+
+/**
+ * @brief No free command slot - the request is dropped
+ * */
+static void test_no_slot(void){
+	static const uint8_t data[] = {0x33};
+	uint8_t line[COBS_ENC_MAX(PROTO_FRAME_MAX) + 2];
+	uint32_t n;
+
+	memset(slot_used, 1, sizeof(slot_used));
+
+	n = build_line(3, data, sizeof(data), line);
+	ring_buff_write(&ring, line, n);
+
+	CHECK(receive() == 0);
+	CHECK(proto_stats.dropped == 1 && posted_num == 0);
+	CHECK(ring_buff_count(&ring) == 0);
+
+	memset(slot_used, 0, sizeof(slot_used));
+	proto_stats.dropped = 0;
+}
+
+/**
+ * @brief The response frame, and the responses lost to a full print queue or an empty pool
+ * */
+static void test_respond(void){
+	static const uint8_t req[PROTO_HDR_SIZE] = {PROTO_VERSION, 0x42, PROTO_CMD_PING};
+	static const uint8_t data[] = {0x00, 0xAB, 0x00};
+	uint8_t rsp[PROTO_FRAME_MAX];
+	int32_t n;
+
+	proto_respond(req, PROTO_OK, data, sizeof(data));
+	CHECK(sent == msg_block && proto_stats.tx_dropped == 0);
+	CHECK(sent[0] == PROTO_DELIM && sent[sent_len - 1] == PROTO_DELIM);
+	CHECK(memchr(&sent[1], PROTO_DELIM, sent_len - 2) == NULL);
+
+	n = cobs_decode(&sent[1], sent_len - 2, rsp, sizeof(rsp));
+	CHECK(n == PROTO_HDR_SIZE + 1 + sizeof(data) + PROTO_CRC_SIZE);
+	CHECK(rsp[0] == PROTO_VERSION && rsp[1] == 0x42 && rsp[2] == (PROTO_CMD_PING | PROTO_RSP));
+	CHECK(rsp[3] == PROTO_OK && memcmp(&rsp[4], data, sizeof(data)) == 0);
+
+	// The print task frees the block
+	msg_pool_free(msg_block);
+
+	// Full print queue - the block goes back to the pool
+	queue_full = 1;
+	proto_respond(req, PROTO_OK, data, sizeof(data));
+	CHECK(proto_stats.tx_dropped == 1);
+	CHECK(msg_used == 0 && msg_frees == 2);
+	queue_full = 0;
+
+	// No message block
+	pool_empty = 1;
+	proto_respond(req, PROTO_OK, data, sizeof(data));
+	CHECK(proto_stats.tx_dropped == 2 && msg_frees == 2);
+	pool_empty = 0;
+}
+
+int main(void){
+	ring_buff_init(&ring, ring_data, RING_SIZE);
+
+	test_partial();
+	test_stray();
+	test_bad_frames();
+	test_no_slot();
+	test_respond();
+
+	return host_result("proto");
+}
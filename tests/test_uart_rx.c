@@ -0,0 +1,202 @@
+/*
+ * test_uart_rx.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: vaknin
+ */
+#include "host.h"
+
+/* The DMA buffer and the reception state are static - the module is part of the test */
+#include "../Core/Src/uart_rx.c"
+
+#define STREAM_SIZE		200000
+
+TaskHandle_t cmd_handler_task_handle;
+
+static UART_HandleTypeDef huart = {.Instance = USART2};
+static uint32_t dma_pos;		/* DMA write position */
+static uint32_t notifications;
+
+static uint8_t stream[STREAM_SIZE];
+static uint8_t received[STREAM_SIZE];
+static uint32_t received_len;
+
+BaseType_t xTaskGenericNotifyFromISR(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+		eNotifyAction eAction, uint32_t* pulPreviousNotificationValue, BaseType_t* pxHigherPriorityTaskWoken){
+	notifications++;
+	return pdPASS;
+}
+
+TickType_t xTaskGetTickCountFromISR(void){
+	return host_tick;
+}
+
+/* The DMA is replayed by the test */
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size){
+	return HAL_OK;
+}
+
+/**
+ * @brief This function writes a burst to the DMA buffer with the HT, TC and IDLE events of the HAL
+ * */
+static void dma_burst(const uint8_t* data, uint32_t len){
+	while(len--){
+		uart_rx_dma_buff[dma_pos++] = *data++;
+
+		// Half transfer, transfer complete (Size is the buffer size)
+		if(dma_pos == UART_RX_DMA_BUFF_SIZE / 2 || dma_pos == UART_RX_DMA_BUFF_SIZE){
+			HAL_UARTEx_RxEventCallback(&huart, dma_pos);
+			dma_pos %= UART_RX_DMA_BUFF_SIZE;
+		}
+	}
+
+	// Idle line
+	HAL_UARTEx_RxEventCallback(&huart, dma_pos);
+}
+
+/**
+ * @brief This function reads the ring like the command task
+ * */
+static void drain(uint32_t max){
+	received_len += ring_buff_read(&uart_rx_ring, &received[received_len], max);
+}
+
+/**
+ * @brief The spans of every tail and head pair of a small buffer
+ * */
+static void test_spans(void){
+	uint8_t buff[8];
+	uart_rx_span_t spans[2];
+	uint32_t tail, head, t, n, len, i;
+
+	for(t = 0; t < sizeof(buff); t++){
+		for(head = 0; head <= sizeof(buff); head++){
+			tail = t;
+			n = uart_rx_spans(&tail, head, buff, sizeof(buff), spans);
+
+			CHECK(tail == head % sizeof(buff));
+			CHECK(n <= 2);
+
+			len = 0;
+			for(i = 0; i < n; i++){
+				CHECK(spans[i].len > 0);
+				CHECK(spans[i].data >= buff && spans[i].data + spans[i].len <= buff + sizeof(buff));
+				len += spans[i].len;
+			}
+			CHECK(len == (head % sizeof(buff) + sizeof(buff) - t) % sizeof(buff));
+
+			// The first span starts at the tail, the second one at the buffer start
+			if(n){
+				CHECK(spans[0].data == &buff[t]);
+			}
+			if(n == 2){
+				CHECK(spans[1].data == buff);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Random bursts replayed through the RX event callback - the ring data is the stream
+ * */
+static void test_replay(void){
+	uint32_t sent = 0;
+	uint32_t len, lines, i, r;
+
+	for(i = 0; i < STREAM_SIZE; i++){
+		r = host_rand() % 32;
+		stream[i] = (r == 0) ? '\n' : (r == 1) ? PROTO_DELIM : 'a' + host_rand() % 26;
+	}
+
+	uart_rx_start(&huart);
+	dma_pos = 0;
+
+	while(sent < STREAM_SIZE){
+		// Up to twice the DMA buffer - the HT and TC events split it
+		len = 1 + host_rand() % (2 * UART_RX_DMA_BUFF_SIZE);
+		if(len > STREAM_SIZE - sent){
+			len = STREAM_SIZE - sent;
+		}
+		if(len > ring_buff_free(&uart_rx_ring)){
+			drain(UART_RX_RING_SIZE);
+			continue;
+		}
+
+		lines = notifications;
+		dma_burst(&stream[sent], len);
+		sent += len;
+
+		// A burst with an end of line or a frame delimiter notifies the task, the others do not
+		if(memchr(&stream[sent - len], '\n', len) || memchr(&stream[sent - len], PROTO_DELIM, len)){
+			CHECK(notifications > lines);
+		}
+		else{
+			CHECK(notifications == lines);
+		}
+
+		drain(host_rand() % UART_RX_RING_SIZE);
+	}
+	drain(UART_RX_RING_SIZE);
+
+	CHECK(received_len == STREAM_SIZE);
+	CHECK(memcmp(stream, received, STREAM_SIZE) == 0);
+	CHECK(uart_rx_stats.bytes == STREAM_SIZE);
+	CHECK(uart_rx_stats.dropped == 0);
+}
+
+/**
+ * @brief The bytes that do not fit the ring are counted and the task is notified
+ * */
+static void test_overflow(void){
+	uint8_t data[UART_RX_RING_SIZE + 40];
+	uint32_t n;
+
+	memset(data, 'x', sizeof(data));
+	uart_rx_stats.dropped = 0;
+	drain(UART_RX_RING_SIZE);
+
+	n = notifications;
+	dma_burst(data, sizeof(data));
+
+	CHECK(uart_rx_stats.dropped == 40);
+	CHECK(notifications > n);
+	CHECK(ring_buff_count(&uart_rx_ring) == UART_RX_RING_SIZE);
+}
+
+/**
+ * @brief A UART error restarts the DMA at the buffer start and keeps the ring data
+ * */
+static void test_error(void){
+	uint8_t line[] = "led 1";
+	uint32_t count;
+
+	received_len = 0;
+	drain(UART_RX_RING_SIZE);
+	received_len = 0;
+
+	// The DMA is aborted in the middle of the buffer
+	dma_burst(line, sizeof(line) - 1);
+	count = ring_buff_count(&uart_rx_ring);
+
+	huart.RxState = HAL_UART_STATE_READY;
+	HAL_UART_ErrorCallback(&huart);
+	dma_pos = 0;
+
+	CHECK(uart_rx_stats.errors == 1);
+	CHECK(ring_buff_count(&uart_rx_ring) == count);
+
+	dma_burst((const uint8_t*)"\n", 1);
+	drain(UART_RX_RING_SIZE);
+
+	CHECK(received_len == sizeof(line));
+	CHECK(memcmp(received, "led 1\n", sizeof(line)) == 0);
+}
+
+int main(void){
+	test_spans();
+	test_replay();
+	test_overflow();
+	test_error();
+
+	return host_result("uart_rx");
+}
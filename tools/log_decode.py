@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+log_decode.py - decode the deferred binary log (Core/Src/dlog.c)
+
+The firmware writes records of 32 bits words to ITM stimulus port 1:
+    0xA5 << 24 | nargs << 20 | id, tick count, args...
+    0xA5 << 24 | 0xF << 20 | id, tick count, length, data (padded to words)
+The id is the offset of the format string in the ELF .log_fmt section (not loaded to the target).
+
+Usage:
+    log_decode.py <firmware.elf> <capture> [--port N] [--raw]
+
+    capture  SWO capture of ITM packets (e.g. the OpenOCD "tpiu config ... swo.bin" output),
+             or the port data words only with --raw
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+DLOG_SYNC = 0xA5
+DLOG_NARGS_BUF = 0xF
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Elf:
+    """Minimal ELF32 little endian section reader"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("%s: not an ELF32 little endian file" % path)
+
+        e_shoff, = struct.unpack_from("<I", self.data, 0x20)
+        e_shentsize, e_shnum, e_shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+
+        self.sections = []
+        for i in range(e_shnum):
+            sh = struct.unpack_from("<IIIIIIIIII", self.data, e_shoff + i * e_shentsize)
+            self.sections.append(sh)
+
+        strtab = self.sections[e_shstrndx]
+        self.names = {}
+        for sh in self.sections:
+            start = strtab[4] + sh[0]
+            name = self.data[start:self.data.index(b"\0", start)].decode()
+            self.names[name] = sh
+
+    def section(self, name):
+        sh = self.names.get(name)
+        if sh is None:
+            raise ValueError("no %s section - was the firmware linked with STM32F407VGTX_FLASH.ld?" % name)
+        return self.data[sh[4]:sh[4] + sh[5]]
+
+    def cstring(self, data, offset):
+        end = data.index(b"\0", offset)
+        return data[offset:end].decode(errors="replace")
+
+    def string_at(self, addr):
+        """Null terminated string at a target address (const strings in flash)"""
+        for sh in self.sections:
+            if sh[2] & SHF_ALLOC and sh[1] != SHT_NOBITS and sh[3] <= addr < sh[3] + sh[5]:
+                return self.cstring(self.data, sh[4] + addr - sh[3])
+        return "<0x%08x>" % addr
+
+
+def itm_words(stream, port):
+    """Extract the 32 bits writes of a stimulus port from an ITM packet stream"""
+    i = 0
+    while i < len(stream):
+        hdr = stream[i]
+        size = hdr & 0x3
+        # Synchronization / overflow / protocol packets
+        if size == 0:
+            i += 1
+            continue
+        size = 4 if size == 3 else size
+        payload = stream[i + 1:i + 1 + size]
+        i += 1 + size
+        # Software source packet of the log port
+        if (hdr & 0x4) == 0 and (hdr >> 3) == port and size == 4 and len(payload) == 4:
+            yield struct.unpack("<I", payload)[0]
+
+
+def raw_words(stream):
+    for i in range(0, len(stream) - 3, 4):
+        yield struct.unpack_from("<I", stream, i)[0]
+
+
+# printf conversion -> python % conversion
+CONV = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diuxXcsp%])")
+
+
+def format_record(elf, fmt, args):
+    out = []
+    pos = 0
+    argi = 0
+    for m in CONV.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, conv = m.group(1), m.group(3)
+        if conv == "%":
+            out.append("%")
+            continue
+        if argi >= len(args):
+            out.append(m.group(0))
+            continue
+        value = args[argi]
+        argi += 1
+        if conv in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            out.append(("%" + flags + "d") % value)
+        elif conv == "u":
+            out.append(("%" + flags + "d") % value)
+        elif conv in "xX":
+            out.append(("%" + flags + conv) % value)
+        elif conv == "p":
+            out.append("0x%08x" % value)
+        elif conv == "c":
+            out.append(("%" + flags + "c") % chr(value & 0xFF))
+        elif conv == "s":
+            out.append(("%" + flags + "s") % (value if isinstance(value, str) else elf.string_at(value)))
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(elf, words):
+    fmts = elf.section(".log_fmt")
+    words = iter(words)
+
+    for hdr in words:
+        if (hdr >> 24) != DLOG_SYNC:
+            continue
+        nargs = (hdr >> 20) & 0xF
+        fmt_id = hdr & 0xFFFFF
+
+        try:
+            tick = next(words)
+            if nargs == DLOG_NARGS_BUF:
+                length = next(words)
+                data = b"".join(struct.pack("<I", next(words)) for _ in range((length + 3) // 4))
+                args = [data[:length].decode(errors="replace")]
+            else:
+                args = [next(words) for _ in range(nargs)]
+        except StopIteration:
+            return
+
+        if fmt_id >= len(fmts):
+            print("[%10u] <bad id 0x%05x>" % (tick, fmt_id))
+            continue
+
+        text = format_record(elf, elf.cstring(fmts, fmt_id), args)
+        sys.stdout.write("[%10u] %s" % (tick, text if text.endswith("\n") else text + "\n"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the deferred binary log")
+    parser.add_argument("elf", help="firmware ELF file")
+    parser.add_argument("capture", help="SWO/ITM capture file")
+    parser.add_argument("--port", type=int, default=1, help="ITM stimulus port (DLOG_ITM_PORT)")
+    parser.add_argument("--raw", action="store_true", help="the capture holds the port data words only")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    with open(args.capture, "rb") as f:
+        stream = f.read()
+
+    decode(elf, raw_words(stream) if args.raw else itm_words(stream, args.port))
+
+
+if __name__ == "__main__":
+    main()
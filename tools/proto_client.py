@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+proto_client.py - binary protocol client (Core/Src/proto.c)
+
+Frame on the line: 0x00 <COBS data> 0x00
+    Request:  version, sequence, command, data..., CRC
+    Response: version, sequence, command | 0x80, status, data..., CRC
+The CRC is the STM32 CRC peripheral CRC-32 (poly 0x04C11DB7, init 0xFFFFFFFF, no reflection) over the
+frame read as little endian 32 bits words, the last word zero padded. The text menu output between the
+frames is skipped.
+
+Usage:
+    proto_client.py <port> [--baud N] <request> [args] [--count N]
+
+    ping [hex]      echo
+    info            tick count, HCLK, clock profile
+    time            Unix time (ms)
+    settime [secs]  set the RTC (default: the host time)
+    led <0-4>       LED effect (0 off)
+    stats           protocol statistics
+
+    --count N sends the request N times without waiting (pipelined) and checks every response.
+    The board keeps up to 32 requests (CMD_POOL_SIZE) - a larger count loses responses.
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+PROTO_VERSION = 1
+PROTO_RSP = 0x80
+
+COMMANDS = {"ping": 0x01, "info": 0x02, "time": 0x10, "settime": 0x11, "led": 0x20, "stats": 0x30}
+STATUS = ["ok", "version", "command", "length", "argument"]
+PROFILES = ["perf", "balanced", "low"]
+
+
+def crc_stm32(data):
+    """CRC peripheral CRC-32 over little endian words"""
+    data = bytes(data) + b"\0" * (-len(data) % 4)
+    crc = 0xFFFFFFFF
+    for i in range(0, len(data), 4):
+        crc ^= struct.unpack_from("<I", data, i)[0]
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7) & 0xFFFFFFFF if crc & 0x80000000 else (crc << 1) & 0xFFFFFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code = 0
+    for b in data:
+        if b == 0:
+            out[code] = len(out) - code
+            code = len(out)
+            out.append(0)
+        else:
+            out.append(b)
+            if len(out) - code == 0xFF:
+                out[code] = 0xFF
+                code = len(out)
+                out.append(0)
+    out[code] = len(out) - code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def request(seq, cmd, data=b""):
+    frame = bytes([PROTO_VERSION, seq & 0xFF, cmd]) + data
+    return b"\0" + cobs_encode(frame + struct.pack("<I", crc_stm32(frame))) + b"\0"
+
+
+class Link:
+    def __init__(self, port, baud):
+        import serial
+        self.port = serial.Serial(port, baud, timeout=0.1)
+        self.rx = bytearray()
+
+    def send(self, data):
+        self.port.write(data)
+
+    def responses(self, timeout):
+        """Yields the valid response frames until timeout"""
+        end = time.monotonic() + timeout
+        while time.monotonic() < end:
+            self.rx += self.port.read(256)
+            while True:
+                start = self.rx.find(b"\0")
+                if start < 0:
+                    # Text output only
+                    del self.rx[:]
+                    break
+                stop = self.rx.find(b"\0", start + 1)
+                if stop < 0:
+                    del self.rx[:start]
+                    break
+                frame = cobs_decode(bytes(self.rx[start + 1:stop]))
+                # The end delimiter may start the next frame
+                del self.rx[:stop]
+                if frame is None or len(frame) < 8:
+                    continue
+                if crc_stm32(frame[:-4]) != struct.unpack_from("<I", frame, len(frame) - 4)[0]:
+                    continue
+                yield frame[:-4]
+
+
+def show(cmd, rsp):
+    seq, status, data = rsp[1], rsp[3], rsp[4:]
+    text = STATUS[status] if status < len(STATUS) else str(status)
+    if status == 1:
+        text += " (board version %d)" % rsp[0]
+    if status != 0:
+        return "seq %3d: error %s" % (seq, text)
+    if cmd == "info":
+        tick, hclk, profile, frame_max = struct.unpack("<IIBB", data)
+        profile = PROFILES[profile] if profile < len(PROFILES) else profile
+        return "seq %3d: tick %d, HCLK %d Hz, clock %s, frame %d bytes" % (seq, tick, hclk, profile, frame_max)
+    if cmd == "time":
+        ms, = struct.unpack("<Q", data)
+        when = time.strftime("%Y-%m-%d %H:%M:%S", time.gmtime(ms // 1000))
+        return "seq %3d: %d ms (%s.%03d)" % (seq, ms, when, ms % 1000)
+    if cmd == "stats":
+        names = ("frames", "crc", "bad", "dropped", "timeouts", "tx dropped")
+        return "seq %3d: " % seq + ", ".join("%s %d" % v for v in zip(names, struct.unpack("<6I", data)))
+    return "seq %3d: ok %s" % (seq, data.hex())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Binary protocol client")
+    parser.add_argument("port", help="serial port (e.g. /dev/ttyUSB0, COM3)")
+    parser.add_argument("request", choices=sorted(COMMANDS))
+    parser.add_argument("arg", nargs="?", help="ping data (hex), settime seconds or led effect")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--count", type=int, default=1, help="pipelined requests")
+    args = parser.parse_args()
+
+    if not 1 <= args.count <= 256:
+        parser.error("--count must be 1 - 256 (8 bits sequence)")
+
+    data = b""
+    if args.request == "ping" and args.arg:
+        data = bytes.fromhex(args.arg)
+    elif args.request == "settime":
+        data = struct.pack("<I", int(args.arg) if args.arg else int(time.time()))
+    elif args.request == "led":
+        data = bytes([int(args.arg or 0)])
+
+    link = Link(args.port, args.baud)
+    pending = set(range(args.count))
+    start = time.monotonic()
+
+    # All the requests first - no wait for the responses
+    link.send(b"".join(request(seq, COMMANDS[args.request], data) for seq in range(args.count)))
+
+    for rsp in link.responses(1.0 + args.count * 0.01):
+        if rsp[2] != COMMANDS[args.request] | PROTO_RSP or rsp[1] not in pending:
+            continue
+        pending.discard(rsp[1])
+        print(show(args.request, rsp))
+        if not pending:
+            break
+
+    elapsed = time.monotonic() - start
+    print("%d/%d responses in %.1f ms" % (args.count - len(pending), args.count, elapsed * 1000))
+    sys.exit(1 if pending else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""
+stack_usage.py - static worst case stack usage of the tasks
+
+Reads the GCC call graph files (-fcallgraph-info=su, set in the Debug configuration) of a build and
+computes the deepest call chain of every task entry function. The tasks and their stack sizes are read
+from the task table (app_tasks) of Core/Src/main.c, the kernel tasks (idle, timer) from FreeRTOSConfig.h.
+Compare the result with the "stack" console command (the measured high-water marks).
+
+Usage:
+    stack_usage.py [build dir (default: Debug)] [--src <project dir>] [-v]
+
+The estimate includes the task context (exception frame and the registers saved by the port, with the
+FPU context). Interrupts run on the main stack and are not included. Indirect calls, recursion and
+functions without a call graph (libraries) are listed as unresolved - the estimate is a lower bound
+for the chains through them.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Exception frame with the FPU context (26 words) + r4-r11, r14, s16-s31 saved by PendSV (25 words)
+CONTEXT_BYTES = (26 + 25) * 4
+
+# Kernel tasks - entry function and stack depth macro
+KERNEL_TASKS = [
+    ("IDLE", "prvIdleTask", "configMINIMAL_STACK_SIZE"),
+    ("Tmr Svc", "prvTimerTask", "configTIMER_TASK_STACK_DEPTH"),
+]
+
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r"\\n(\d+) bytes \(([a-z,]+)\)")
+# xTaskCreate() calls or the app_tasks[] table rows of main.c - entry, "name", depth
+TASK = re.compile(r'(?:xTaskCreate(?:Static)?\(|\{)\s*(\w+)\s*,\s*"([^"]+)"\s*,\s*([^,]+),')
+DEFINE = re.compile(r"^\s*#define\s+(\w+)\s+(.+?)\s*(?://.*)?$", re.M)
+
+
+class CallGraph:
+    def __init__(self):
+        self.frames = {}      # function -> (bytes, qualifier)
+        self.calls = {}       # function -> set of callees
+        self.names = {}       # bare name -> titles (static functions are "file.c:name")
+
+    def load(self, path):
+        with open(path) as f:
+            text = f.read()
+
+        for title, label in NODE.findall(text):
+            m = FRAME.search(label)
+            if m:
+                self.frames[title] = (int(m.group(1)), m.group(2))
+            self.names.setdefault(title.split(":")[-1], set()).add(title)
+
+        for src, dst in EDGE.findall(text):
+            self.calls.setdefault(src, set()).add(dst)
+
+    def resolve(self, name):
+        """Title of a function with a frame - the external node of another file is resolved by name"""
+        if name in self.frames:
+            return name
+        titles = [t for t in self.names.get(name.split(":")[-1], ()) if t in self.frames]
+        return titles[0] if len(titles) == 1 else None
+
+    def worst(self, func, memo, path, unresolved):
+        """Worst case stack of func and its callees - returns (bytes, chain)"""
+        title = self.resolve(func)
+        if title is None:
+            unresolved.add(func)
+            return 0, [func]
+        if title in path:
+            unresolved.add("recursion: " + title)
+            return 0, [title]
+        if title in memo:
+            return memo[title]
+
+        frame, qualifier = self.frames[title]
+        if "dynamic" in qualifier:
+            unresolved.add("dynamic frame: " + title)
+
+        path.add(title)
+        best = (0, [])
+        for callee in sorted(self.calls.get(title, ())):
+            if callee == "__indirect_call":
+                unresolved.add("indirect call: " + title)
+                continue
+            best = max(best, self.worst(callee, memo, path, unresolved), key=lambda r: r[0])
+        path.discard(title)
+
+        memo[title] = (frame + best[0], [title] + best[1])
+        return memo[title]
+
+
+def read_defines(paths):
+    defines = {}
+    for path in paths:
+        if os.path.exists(path):
+            with open(path) as f:
+                defines.update(DEFINE.findall(f.read()))
+    return defines
+
+
+def evaluate(expr, defines, depth=0):
+    """Value of a stack depth expression (numbers, macros, casts and arithmetic)"""
+    expr = re.sub(r"\(\s*(?:unsigned\s+short|uint16_t|uint32_t|size_t|configSTACK_DEPTH_TYPE)\s*\)", "", expr)
+    if depth < 8:
+        expr = re.sub(r"[A-Za-z_]\w*", lambda m: "(%s)" % evaluate(defines[m.group(0)], defines, depth + 1)
+                      if m.group(0) in defines else m.group(0), expr)
+    try:
+        return int(eval(expr, {"__builtins__": {}}))
+    except Exception:
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static worst case stack usage of the tasks")
+    parser.add_argument("build", nargs="?", default="Debug", help="build directory with the .ci files")
+    parser.add_argument("--src", default=".", help="project directory")
+    parser.add_argument("-v", "--verbose", action="store_true", help="print the worst case call chains")
+    args = parser.parse_args()
+
+    graph = CallGraph()
+    files = 0
+    for root, _, names in os.walk(args.build):
+        for name in names:
+            if name.endswith(".ci"):
+                graph.load(os.path.join(root, name))
+                files += 1
+
+    if files == 0:
+        sys.exit("no .ci files in %s - build with -fcallgraph-info=su" % args.build)
+
+    inc = os.path.join(args.src, "Core", "Inc")
+    main_c = os.path.join(args.src, "Core", "Src", "main.c")
+    defines = read_defines([os.path.join(inc, "FreeRTOSConfig.h"), os.path.join(inc, "main.h"), main_c])
+
+    with open(main_c) as f:
+        tasks = [(name, func, depth) for func, name, depth in TASK.findall(f.read())]
+    tasks += KERNEL_TASKS
+
+    print("%-10s %8s %8s %8s  (words)" % ("Task", "Static", "Size", "Margin"))
+    for name, func, depth in tasks:
+        unresolved = set()
+        used, chain = graph.worst(func, {}, set(), unresolved)
+        words = (used + CONTEXT_BYTES + 3) // 4
+        size = evaluate(depth, defines)
+
+        margin = "%8d" % (size - words) if size is not None else "%8s" % "?"
+        print("%-10s %8d %8s %s%s" % (name, words, size if size is not None else depth, margin,
+                                      "  +unresolved" if unresolved else ""))
+
+        if args.verbose:
+            print("    " + " -> ".join(chain))
+            for item in sorted(unresolved):
+                print("    ? " + item)
+
+
+if __name__ == "__main__":
+    main()